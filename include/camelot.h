@@ -20,7 +20,12 @@ extern "C" {
 // --- MODULES ---
 #include "camelot/io.h"
 #include "camelot/memory.h"
+#include "ds/deque.h"
+#include "ds/frame.h"
+#include "ds/hash.h"
+#include "ds/journal.h"
 #include "ds/list.h"
+#include "ds/queue.h"
 #include "ds/table.h"
 #include "types/primitives.h"
 #include "types/string.h"
@@ -28,6 +28,13 @@ typedef struct {
 
 typedef enum { OPEN, READ, SKIP, CLOSE } Op;
 
+// Output buffering policy for io.put / io.print (per thread).
+typedef enum {
+	FLUSH_LINE, // Flush when a call writes a newline (default for terminals)
+	FLUSH_FULL, // Flush only when the buffer fills (default for pipes/files)
+	FLUSH_NONE, // Unbuffered: every call reaches the descriptor immediately
+} Flush;
+
 // --- NAMESPACE ---
 
 typedef struct {
@@ -38,18 +45,36 @@ typedef struct {
 	 * String name = io.scan(&ctx, 0);
 	 * ```
 	 * INVARIANTS: Result is always null-terminated. Handles CRLF/LF
-	 * automatically. FAILURE MODES: Returns empty string if EOF reached or
-	 * allocation fails.
+	 * automatically. Consumes from a shared 64 KiB read-ahead buffer, so
+	 * input beyond 'cap' remains available to the next call.
+	 * FAILURE MODES: Returns empty string if EOF reached or allocation fails.
 	 */
 	String (*scan)(Arena *a, u64 cap);
 
+	/*
+	 * INTENT: Yields the next stdin line as a zero-copy view into the
+	 * read-ahead buffer.
+	 * USAGE:
+	 * ```
+	 * String line;
+	 * while (io.lines(&line)) { ... }
+	 * ```
+	 * INVARIANTS: The trailing LF/CRLF is stripped; a CR not followed by LF
+	 * is kept. The view stays valid only until the next call to io.lines or
+	 * io.scan; copy it to keep it. Not thread-safe: stdin has a single reader.
+	 * FAILURE MODES: Returns false at EOF. Lines longer than 64 KiB are
+	 * yielded in window-sized pieces.
+	 */
+	bool (*lines)(String *line);
+
 	/*
 	 * INTENT: Writes a raw String view to stdout.
 	 * USAGE:
 	 * ```
 	 * io.put(s);
 	 * ```
-	 * INVARIANTS: Does not append newline. O(1) if write buffers are available.
+	 * INVARIANTS: Does not append newline. Appends to the calling thread's
+	 * output buffer; reaches stdout according to the active Flush policy.
 	 * FAILURE MODES: Silent failure if stdout is closed.
 	 */
 	void (*put)(String s);
@@ -60,11 +85,48 @@ typedef struct {
 	 * ```
 	 * io.print("User: %S\n", name);
 	 * ```
-	 * INVARIANTS: Thread-safe if underlying libc write is thread-safe.
-	 * FAILURE MODES: Truncates output if internal buffers (rare) are exceeded.
+	 * INVARIANTS: Formats into the calling thread's output buffer. Each thread
+	 * owns its buffer, so lines from different threads never interleave mid-call.
+	 * FAILURE MODES: Silent failure if stdout is closed.
 	 */
 	void (*print)(const char *fmt, ...);
 
+	/*
+	 * INTENT: Writes the calling thread's pending output to stdout.
+	 * USAGE:
+	 * ```
+	 * io.flush();
+	 * ```
+	 * INVARIANTS: Called automatically at process exit, at thread exit, and
+	 * before io.scan blocks on stdin.
+	 * FAILURE MODES: Pending bytes are dropped if stdout is closed.
+	 */
+	void (*flush)(void);
+
+	/*
+	 * INTENT: Selects the output buffering policy for the calling thread.
+	 * USAGE:
+	 * ```
+	 * io.policy(FLUSH_FULL);
+	 * ```
+	 * INVARIANTS: Pending output is flushed before the policy changes.
+	 * FAILURE MODES: None.
+	 */
+	void (*policy)(Flush mode);
+
+	/*
+	 * INTENT: Prints an Arena's usage report: capacity, and with
+	 * CAMELOT_ARENA_STATS also peak, padding waste, a size histogram, per-site
+	 * totals and the site of the first OOM.
+	 * USAGE:
+	 * ```
+	 * io.report(&ctx);
+	 * ```
+	 * INVARIANTS: Goes through the same buffer as io.print.
+	 * FAILURE MODES: Without instrumentation only 'len' and 'cap' are shown.
+	 */
+	void (*report)(const Arena *a);
+
 	/*
 	 * INTENT: Reads an entire file into memory and auto-closes the handle.
 	 * USAGE:
@@ -14,8 +14,59 @@
 extern "C" {
 #endif
 
+#include <stdatomic.h>
+
 #include "types/primitives.h"
 
+// Destructive-interference boundary used to keep hot data on separate lines.
+#define CACHE_LINE 64
+
+// How an Arena scrubs memory it hands back out.
+typedef enum {
+	ZERO_EAGER = 0, // memset on clear (default, security guarantee)
+	ZERO_LAZY,		// Large regions are returned to the OS and refault as zero pages
+	ZERO_NONE,		// No scrubbing; for non-sensitive scratch memory only
+} ZeroPolicy;
+
+// Page backing: requested through ArenaOptions.pages, and reported back in
+// Arena.pages with what the OS actually granted.
+typedef enum {
+	PAGES_HUGE = 1 << 0,	 // Request huge pages (hugetlbfs, else THP)
+	PAGES_PREFAULT = 1 << 1, // Request/granted: committed pages prefaulted
+	PAGES_HUGETLB = 1 << 2,	 // Granted: explicit MAP_HUGETLB pages
+	PAGES_THP = 1 << 3,		 // Granted: THP advice taken and THP not "never"
+} PageFlags;
+
+struct SharedArena;
+struct ArenaImage;
+struct Heap;
+
+#ifdef CAMELOT_ARENA_STATS
+#define ARENA_STATS_SITES 32
+
+// Allocation totals attributed to one source location.
+typedef struct {
+	const char *file; // NULL = allocations made without ARENA_SITE
+	u32 line;
+	u64 count;
+	u64 bytes;
+} ArenaSite;
+
+// Opt-in instrumentation (compile with -DCAMELOT_ARENA_STATS).
+typedef struct {
+	u64 peak;		   // High-water mark of 'len'
+	u64 count;		   // Successful allocations
+	u64 bytes;		   // Bytes requested by successful allocations
+	u64 padding;	   // Bytes lost to alignment
+	u64 failures;	   // Allocations refused with OOM
+	u64 histogram[64]; // Allocations by bit length of their size
+	ArenaSite sites[ARENA_STATS_SITES];
+	ArenaSite oom;		// Site of the first refused allocation
+	const char *next_file; // Pending site set by ARENA_SITE
+	u32 next_line;
+} ArenaStats;
+#endif
+
 // The raw Linear Allocator struct.
 // Represents a borrowing reference to a memory context.
 typedef struct {
@@ -23,12 +74,52 @@ typedef struct {
 	u64 len;
 	u64 cap;
 	Result status;
+	u64 reserved; // Virtual range size (0 = fixed block, no growth)
+	u64 floor;	  // Committed bytes retained by arena.clear
+	ZeroPolicy zero;
+	u64 align; // Default alignment for arena.alloc (0 = 8 bytes)
+	struct SharedArena *shared; // Parent region when this is a thread view
+	struct ArenaImage *image;	// File header when backed by a snapshot file
+	u32 pages;					// PageFlags granted at creation
+	struct Heap *heap;			// Heap serving this view (see heap.arena)
+#ifdef CAMELOT_ARENA_STATS
+	ArenaStats *stats; // Created on first allocation, freed on release
+#endif
 } Arena;
 
+// Creation parameters for a growable Arena (see arena.reserve).
+typedef struct {
+	u64 reserve; // Upper bound of the virtual address range
+	u64 commit;	 // Bytes made usable up front
+	u64 floor;	 // Bytes kept committed when the arena is cleared
+	ZeroPolicy zero;
+	u64 align; // Default alignment for arena.alloc (0 = 8 bytes)
+	u32 pages; // PAGES_HUGE and/or PAGES_PREFAULT
+} ArenaOptions;
+
+// A saved Arena cursor position (see arena.mark).
+typedef struct {
+	Arena *arena;
+	u64 len;
+} ArenaMark;
+
 // A scoped, owning Arena that cleans itself up automatically.
 static inline void _cleanup_arena_func(Arena *a);
 #define Workspace __attribute__((cleanup(_cleanup_arena_func))) Arena
 
+// A scoped savepoint that rewinds its Arena automatically.
+static inline void _cleanup_mark_func(ArenaMark *m);
+#define Savepoint __attribute__((cleanup(_cleanup_mark_func))) ArenaMark
+
+// Attributes the next allocation on 'a' to the current source line.
+// Compiles to plain 'a' unless CAMELOT_ARENA_STATS is defined.
+#ifdef CAMELOT_ARENA_STATS
+#define ARENA_SITE(a) arena.trace((a), __FILE__, __LINE__)
+#else
+#define ARENA_SITE(a) (a)
+#endif
+#define ARENA_ALLOC(a, size) arena.alloc(ARENA_SITE(a), (size))
+
 // --- NAMESPACE ---
 
 typedef struct {
@@ -38,11 +129,73 @@ typedef struct {
 	 * ```
 	 * Workspace ctx = arena.create(1024);
 	 * ```
-	 * INVARIANTS: Memory is securely zeroed upon creation.
+	 * INVARIANTS: Memory is securely zeroed upon creation (large blocks come
+	 * pre-zeroed from the OS and are not touched). Zero policy is ZERO_EAGER.
 	 * FAILURE MODES: Returns status=OOM if OS refuses allocation.
 	 */
 	Arena (*create)(u64 size);
 
+	/*
+	 * INTENT: Creates a growable memory context backed by a reserved virtual
+	 * range; pages are committed on demand as allocations need them.
+	 * USAGE:
+	 * ```
+	 * Workspace ctx = arena.reserve((ArenaOptions){.reserve = 1ULL << 30});
+	 * ```
+	 * INVARIANTS: The range never moves, so every returned pointer stays valid
+	 * as the arena grows. Fresh pages are zero-filled by the OS. opts.zero
+	 * selects how arena.clear scrubs (ZERO_EAGER unless set). opts.pages may
+	 * request huge pages and prefaulting; check the returned 'pages' for
+	 * what was granted. Explicit huge pages are committed in full and are
+	 * not decommitted by arena.clear.
+	 * FAILURE MODES: Returns status=OOM if the range cannot be reserved.
+	 */
+	Arena (*reserve)(ArenaOptions opts);
+
+	/*
+	 * INTENT: Creates (or reloads) an Arena backed by a memory-mapped file so
+	 * a fully built arena can be snapshotted and re-mapped on the next start.
+	 * USAGE:
+	 * ```
+	 * Workspace db = arena.map("lookup.img", 64 << 20);
+	 * Table *t = arena.root(&db);
+	 * if (!t) { ...build, then arena.snapshot(&db, t); }
+	 * ```
+	 * INVARIANTS: A valid image is mapped back at its original address, so
+	 * pointers between objects inside the arena stay valid; 'size' is then
+	 * ignored. An image whose header, version or checksum does not match (or
+	 * was modified after its last snapshot) is rejected and reformatted
+	 * empty. Only data inside the arena survives: String keys from
+	 * string.from and the 'source' fields of containers must be re-pointed.
+	 * FAILURE MODES: status=FILE_NOT_FOUND if the file cannot be opened;
+	 * status=IO_ERROR if it holds foreign data, cannot be mapped, or is a
+	 * valid image whose address is already in use (the file is kept).
+	 */
+	Arena (*map)(const char *path, u64 size);
+
+	/*
+	 * INTENT: Persists a file-backed arena and records its root object.
+	 * USAGE:
+	 * ```
+	 * arena.snapshot(&db, &table_in_arena);
+	 * ```
+	 * INVARIANTS: Writes length, root offset and checksum into the header and
+	 * flushes data to disk (msync).
+	 * FAILURE MODES: Returns IO_ERROR for non-file arenas or failed syncs.
+	 */
+	Result (*snapshot)(Arena *a, void *root);
+
+	/*
+	 * INTENT: Returns the root object recorded by the last snapshot.
+	 * USAGE:
+	 * ```
+	 * Table *t = arena.root(&db);
+	 * ```
+	 * INVARIANTS: O(1).
+	 * FAILURE MODES: Returns NULL for fresh images and non-file arenas.
+	 */
+	void *(*root)(Arena *a);
+
 	/*
 	 * INTENT: Returns memory to the OS.
 	 * USAGE:
@@ -55,36 +208,349 @@ typedef struct {
 	void (*release)(Arena *a);
 
 	/*
-	 * INTENT: Resets cursor to zero and securely zeroes buffer content.
+	 * INTENT: Resets cursor to zero and scrubs buffer content per the arena's
+	 * ZeroPolicy (securely zeroed by default).
 	 * USAGE:
 	 * ```
 	 * arena.clear(&a);
 	 * ```
-	 * INVARIANTS: Capacity remains unchanged.
+	 * INVARIANTS: Capacity remains unchanged for fixed arenas. Growable arenas
+	 * decommit back to their configured floor.
 	 * FAILURE MODES: None.
 	 */
 	void (*clear)(Arena *a);
 
 	/*
-	 * INTENT: Reserves 'size' bytes from the linear buffer with 8-byte alignment.
+	 * INTENT: Reserves 'size' bytes from the linear buffer with the arena's
+	 * default alignment.
 	 * USAGE:
 	 * ```
 	 * int *x = arena.alloc(&ctx, sizeof(int));
 	 * ```
-	 * INVARIANTS: Returned pointer is 8-byte aligned.
-	 * FAILURE MODES: Returns NULL and sets a->status=OOM if full.
+	 * INVARIANTS: Returned pointer is 8-byte aligned unless the arena was
+	 * configured with a larger ArenaOptions.align. Growable arenas commit
+	 * more pages instead of failing.
+	 * FAILURE MODES: Returns NULL and sets a->status=OOM if full (or if the
+	 * reserved range is exhausted).
 	 */
 	void *(*alloc)(Arena *a, u64 size);
+
+	/*
+	 * INTENT: Reserves 'size' bytes aligned to 'align' (e.g. 32 for AVX loads,
+	 * CACHE_LINE to avoid false sharing).
+	 * USAGE:
+	 * ```
+	 * f32 *v = arena.alloc_aligned(&ctx, 256 * sizeof(f32), 32);
+	 * ```
+	 * INVARIANTS: 'align' is rounded up to a power of two. Only the padding
+	 * needed to reach the boundary is consumed.
+	 * FAILURE MODES: Returns NULL and sets a->status=OOM if full.
+	 */
+	void *(*alloc_aligned)(Arena *a, u64 size, u64 align);
+
+	/*
+	 * INTENT: Grows (or shrinks) an allocation, in place when it is the most
+	 * recent one, otherwise by copying into a fresh block.
+	 * USAGE:
+	 * ```
+	 * buf = arena.extend(&ctx, buf, old_size, new_size);
+	 * ```
+	 * INVARIANTS: The first min(old_size, new_size) bytes are preserved. A
+	 * copied block keeps the original alignment (up to CACHE_LINE); the old
+	 * block is abandoned (recycled on heap views, so do not read it after).
+	 * NULL 'ptr' behaves like alloc. Shrinking to 0 keeps 'ptr' valid, on
+	 * heap views too (unlike heap.resize, which recycles it).
+	 * FAILURE MODES: Returns NULL and sets a->status=OOM if full; the
+	 * original block is untouched.
+	 */
+	void *(*extend)(Arena *a, void *ptr, u64 old_size, u64 new_size);
+
+	/*
+	 * INTENT: Records the current cursor so later allocations can be undone.
+	 * USAGE:
+	 * ```
+	 * Savepoint sp = arena.mark(&ctx);
+	 * ```
+	 * INVARIANTS: O(1). Does not allocate.
+	 * FAILURE MODES: None.
+	 */
+	ArenaMark (*mark)(Arena *a);
+
+	/*
+	 * INTENT: Rolls the arena back to a savepoint, freeing everything
+	 * allocated after it.
+	 * USAGE:
+	 * ```
+	 * arena.rewind(sp);
+	 * ```
+	 * INVARIANTS: Released bytes are scrubbed per the arena's ZeroPolicy.
+	 * Pointers obtained after the mark become invalid.
+	 * FAILURE MODES: No-op if the arena is already at or behind the mark.
+	 */
+	void (*rewind)(ArenaMark m);
+
+	/*
+	 * INTENT: Borrows one of the calling thread's two scratch arenas,
+	 * avoiding the one passed in (typically the caller's output arena).
+	 * USAGE:
+	 * ```
+	 * Savepoint tmp = arena.scratch(out);
+	 * u8 *work = arena.alloc(tmp.arena, 4096);
+	 * ```
+	 * INVARIANTS: Growable and never zeroed (ZERO_NONE); memory is released
+	 * when the thread exits. Rewinding the returned mark returns the space.
+	 * FAILURE MODES: Returns a mark with arena->status=OOM if the scratch
+	 * range cannot be reserved.
+	 */
+	ArenaMark (*scratch)(Arena *conflict);
+
+	/*
+	 * INTENT: Tags the next allocation on the arena with a call site. Used by
+	 * the ARENA_SITE / ARENA_ALLOC macros rather than called directly.
+	 * USAGE:
+	 * ```
+	 * Node *n = ARENA_ALLOC(&ctx, sizeof(Node));
+	 * ```
+	 * INVARIANTS: Returns 'a'. No-op unless built with CAMELOT_ARENA_STATS.
+	 * FAILURE MODES: Tags are dropped if the stats block cannot be allocated.
+	 */
+	Arena *(*trace)(Arena *a, const char *file, u32 line);
 } ArenaNamespace;
 
 extern const ArenaNamespace arena;
 
+// A Fixed-Size Object Pool.
+// Carves equal slots from an Arena in slabs and recycles freed slots through
+// an intrusive free list. Slots live as long as the source Arena. A Pool is
+// owned by one thread like its Arena, so it has no per-thread slot caches:
+// give each thread its own Pool, e.g. over an Arena from shared.attach.
+typedef struct {
+	Arena *source;
+	void *free_list; // Recycled slots (first word links to the next)
+	u8 *slab_next;	 // Unused tail of the current slab
+	u8 *slab_end;
+	u64 slot_size;
+	u64 slab_slots;
+	u64 live; // Slots currently handed out
+} Pool;
+
+typedef struct {
+	/*
+	 * INTENT: Initializes a Pool of 'slot_size' byte objects on the Arena.
+	 * USAGE:
+	 * ```
+	 * Pool sessions = pool.create(&ctx, sizeof(Session), 0);
+	 * ```
+	 * INVARIANTS: Owns no memory until first alloc. 'slab_slots' slots are
+	 * carved per slab (0 = 64). Slots are 8-byte aligned and at least one
+	 * pointer wide.
+	 * FAILURE MODES: Returns valid struct; allocation failures occur on alloc.
+	 */
+	Pool (*create)(Arena *a, u64 slot_size, u64 slab_slots);
+
+	/*
+	 * INTENT: Hands out one slot, reusing a recycled one when available.
+	 * USAGE:
+	 * ```
+	 * Session *s = pool.alloc(&sessions);
+	 * ```
+	 * INVARIANTS: O(1). Slots are zeroed unless the Arena uses ZERO_NONE.
+	 * FAILURE MODES: Returns NULL and sets source->status=OOM if a new slab
+	 * cannot be carved.
+	 */
+	void *(*alloc)(Pool *p);
+
+	/*
+	 * INTENT: Returns a slot to the pool for reuse.
+	 * USAGE:
+	 * ```
+	 * pool.recycle(&sessions, s);
+	 * ```
+	 * INVARIANTS: O(1). The slot must have come from this pool and must not
+	 * be used afterwards. Memory stays in the Arena until it is released.
+	 * FAILURE MODES: No-op on NULL.
+	 */
+	void (*recycle)(Pool *p, void *slot);
+} PoolNamespace;
+
+extern const PoolNamespace pool;
+
+// A Thread-Safe Arena.
+// Threads carve chunks from one backing region with a single atomic step,
+// then bump-allocate inside their chunk through an ordinary Arena view.
+typedef struct SharedArena {
+	u8 *buf;
+	u64 cap;
+	u64 chunk;			 // Bytes handed to a view per refill
+	_Atomic u64 carved;	 // Bytes claimed from the backing region
+	_Atomic u64 used;	 // Bytes allocated by retired chunks and direct allocs
+	_Atomic Result status;
+} SharedArena;
+
+typedef struct {
+	/*
+	 * INTENT: Maps a backing region that many threads may allocate from.
+	 * USAGE:
+	 * ```
+	 * SharedArena results = shared.create(1ULL << 30, 0);
+	 * ```
+	 * INVARIANTS: Pages are committed by the OS on first touch and are zero.
+	 * 'chunk' is the per-view refill size (0 = 64 KiB).
+	 * FAILURE MODES: Returns status=OOM if the region cannot be mapped.
+	 */
+	SharedArena (*create)(u64 size, u64 chunk);
+
+	/*
+	 * INTENT: Unmaps the backing region.
+	 * USAGE:
+	 * ```
+	 * shared.release(&results);
+	 * ```
+	 * INVARIANTS: All views must be released first; their memory goes too.
+	 * FAILURE MODES: Safe to call on empty regions.
+	 */
+	void (*release)(SharedArena *s);
+
+	/*
+	 * INTENT: Opens a thread-local Arena view over the shared region.
+	 * USAGE:
+	 * ```
+	 * Workspace local = shared.attach(&results);
+	 * List rows = list.create(&local, sizeof(Row));
+	 * ```
+	 * INVARIANTS: The view works with every Arena API (arena.alloc, List,
+	 * Table). Allocation is lock-free bump allocation; only chunk refills
+	 * touch shared state. arena.release on the view detaches it and reports
+	 * its usage. One view per thread; views are not thread-safe themselves.
+	 * FAILURE MODES: Allocation sets view.status=OOM when the region is full.
+	 */
+	Arena (*attach)(SharedArena *s);
+
+	/*
+	 * INTENT: Allocates directly from the shared region from any thread.
+	 * USAGE:
+	 * ```
+	 * Node *n = shared.alloc(&results, sizeof(Node));
+	 * ```
+	 * INVARIANTS: Lock-free (one CAS loop). 8-byte aligned.
+	 * FAILURE MODES: Returns NULL and sets s->status=OOM if full.
+	 */
+	void *(*alloc)(SharedArena *s, u64 size);
+
+	/*
+	 * INTENT: Reports combined usage across retired views and direct allocs.
+	 * USAGE:
+	 * ```
+	 * u64 bytes = shared.usage(&results);
+	 * ```
+	 * INVARIANTS: Views still attached are counted once they detach or
+	 * refill; 'carved' bounds the total from above.
+	 * FAILURE MODES: None.
+	 */
+	u64 (*usage)(SharedArena *s);
+} SharedNamespace;
+
+extern const SharedNamespace shared;
+
+// Size-class geometry of the Heap (TLSF): 16 classes per power of two,
+// blocks up to 1 TiB.
+#define HEAP_SL_COUNT 16
+#define HEAP_FL_COUNT 34
+
+struct HeapBlock;
+
+// A General-Purpose Heap.
+// Two-Level Segregated Fit allocator with free/realloc, sub-allocating
+// regions from an Arena. Every operation is O(1) with a bounded worst case.
+typedef struct Heap {
+	Arena *source;
+	u64 region; // Bytes requested from the source per growth step
+	u64 used;	// Payload bytes currently handed out
+	u64 fl_bitmap;
+	u32 sl_bitmap[HEAP_FL_COUNT];
+	struct HeapBlock *lists[HEAP_FL_COUNT][HEAP_SL_COUNT];
+} Heap;
+
+typedef struct {
+	/*
+	 * INTENT: Initializes a Heap that grows by carving regions from the Arena.
+	 * USAGE:
+	 * ```
+	 * Heap h = heap.create(&ctx, 0);
+	 * ```
+	 * INVARIANTS: Owns no memory until first alloc. 'region' is the growth
+	 * step (0 = 256 KiB); larger requests get a dedicated region. Memory
+	 * returns to the OS only when the source Arena is released.
+	 * FAILURE MODES: Returns valid struct; allocation failures occur on alloc.
+	 */
+	Heap (*create)(Arena *a, u64 region);
+
+	/*
+	 * INTENT: Allocates 'size' bytes.
+	 * USAGE:
+	 * ```
+	 * Session *s = heap.alloc(&h, sizeof(Session));
+	 * ```
+	 * INVARIANTS: O(1) via two bitmap scans. 8-byte aligned. Contents are
+	 * not zeroed.
+	 * FAILURE MODES: Returns NULL (and source->status=OOM) if the Arena is
+	 * full. Size 0 returns a minimum-size block, never NULL.
+	 */
+	void *(*alloc)(Heap *h, u64 size);
+
+	/*
+	 * INTENT: Resizes a block, in place when the next block is free.
+	 * USAGE:
+	 * ```
+	 * buf = heap.resize(&h, buf, 4096);
+	 * ```
+	 * INVARIANTS: O(1) plus the copy when the block has to move. NULL 'ptr'
+	 * allocates; size 0 recycles and returns NULL.
+	 * FAILURE MODES: Returns NULL and leaves 'ptr' intact if out of memory.
+	 */
+	void *(*resize)(Heap *h, void *ptr, u64 size);
+
+	/*
+	 * INTENT: Frees a block for reuse, coalescing with free neighbours.
+	 * USAGE:
+	 * ```
+	 * heap.recycle(&h, s);
+	 * ```
+	 * INVARIANTS: O(1). The block must have come from this heap.
+	 * FAILURE MODES: No-op on NULL.
+	 */
+	void (*recycle)(Heap *h, void *ptr);
+
+	/*
+	 * INTENT: Opens an Arena view that allocates from the heap, so List,
+	 * Table and String code can run on it unchanged.
+	 * USAGE:
+	 * ```
+	 * Arena view = heap.arena(&h);
+	 * List l = list.create(&view, sizeof(int));
+	 * ```
+	 * INVARIANTS: arena.alloc maps to heap allocation and arena.extend to
+	 * heap.resize, so grown List directories and Table arrays are freed
+	 * instead of abandoned. arena.clear / mark / rewind are no-ops.
+	 * FAILURE MODES: Allocation failures set view.status=OOM.
+	 */
+	Arena (*arena)(Heap *h);
+} HeapNamespace;
+
+extern const HeapNamespace heap;
+
 // Internal Cleanup Helper
 static inline void _cleanup_arena_func(Arena *a) {
 	if (a && a->buf)
 		arena.release(a);
 }
 
+// Internal Savepoint Helper
+static inline void _cleanup_mark_func(ArenaMark *m) {
+	if (m && m->arena)
+		arena.rewind(*m);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,126 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+#ifndef CAMELOT_DEQUE_H
+#define CAMELOT_DEQUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "camelot/memory.h"
+#include "ds/list.h"
+
+// A Paged Ring-Buffer Double-Ended Queue.
+// Slots form a ring over a circular directory of pages. Pages are
+// allocated on first use and then recycled as the ring turns, so memory is
+// bounded by the peak size. Uses the same page geometry as List.
+typedef struct {
+	Arena *source;
+	void **pages;  // Circular directory; NULL = page not allocated yet
+	u64 pages_cap; // Power of two
+	u64 item_size;
+	u32 page_shift;
+	u64 page_mask;
+	u64 head; // Ring slot of the front item
+	u64 count;
+} Deque;
+
+// --- NAMESPACE ---
+
+typedef struct {
+	/*
+	 * INTENT: Initializes an empty deque on the given Arena.
+	 * USAGE:
+	 * ```
+	 * Deque jobs = deque.create(&ctx, sizeof(Job));
+	 * ```
+	 * INVARIANTS: Only a small directory is allocated up front.
+	 * FAILURE MODES: Returns a deque with no directory on OOM; every push
+	 * then fails.
+	 */
+	Deque (*create)(Arena *a, u64 item_size);
+
+	/*
+	 * INTENT: Appends a copy of the item at the back.
+	 * USAGE:
+	 * ```
+	 * deque.push_back(&jobs, &job);
+	 * ```
+	 * INVARIANTS: O(1). A full ring doubles its directory; items are not
+	 * moved except for one partial page.
+	 * FAILURE MODES: Returns false (deque unchanged) on OOM.
+	 */
+	bool (*push_back)(Deque *d, const void *item);
+
+	/*
+	 * INTENT: Prepends a copy of the item at the front.
+	 * USAGE:
+	 * ```
+	 * deque.push_front(&jobs, &urgent);
+	 * ```
+	 * INVARIANTS: Same as push_back.
+	 * FAILURE MODES: Returns false (deque unchanged) on OOM.
+	 */
+	bool (*push_front)(Deque *d, const void *item);
+
+	/*
+	 * INTENT: Removes the front item, copying it to 'out' if not NULL.
+	 * USAGE:
+	 * ```
+	 * Job job;
+	 * while (deque.pop_front(&jobs, &job)) { ... }
+	 * ```
+	 * INVARIANTS: FIFO with push_back. The page stays in the ring for reuse.
+	 * FAILURE MODES: Returns false if empty.
+	 */
+	bool (*pop_front)(Deque *d, void *out);
+
+	/*
+	 * INTENT: Removes the back item, copying it to 'out' if not NULL.
+	 * USAGE:
+	 * ```
+	 * deque.pop_back(&jobs, &job);
+	 * ```
+	 * INVARIANTS: LIFO with push_back.
+	 * FAILURE MODES: Returns false if empty.
+	 */
+	bool (*pop_back)(Deque *d, void *out);
+
+	/*
+	 * INTENT: Retrieves the item 'index' positions from the front.
+	 * USAGE:
+	 * ```
+	 * Job *next = deque.get(&jobs, 0);
+	 * ```
+	 * INVARIANTS: O(1). Pointers are valid until the item is popped; growth
+	 * relocates only items that shared the front item's page.
+	 * FAILURE MODES: Returns NULL if index >= count.
+	 */
+	void *(*get)(Deque *d, u64 index);
+
+	/*
+	 * INTENT: Empties the deque, keeping its pages for reuse.
+	 * USAGE:
+	 * ```
+	 * deque.clear(&jobs);
+	 * ```
+	 * INVARIANTS: Item contents are not scrubbed.
+	 * FAILURE MODES: None.
+	 */
+	void (*clear)(Deque *d);
+} DequeNamespace;
+
+extern const DequeNamespace deque;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+#ifndef CAMELOT_FRAME_H
+#define CAMELOT_FRAME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h> // offsetof
+
+#include "camelot/memory.h"
+#include "ds/list.h"
+
+// Where one field lives inside a row struct.
+typedef struct {
+	u64 offset;
+	u64 size;
+} FrameColumn;
+
+// Describes field 'f' of row struct 'T' as a column.
+#define FRAME_FIELD(T, f) ((FrameColumn){offsetof(T, f), sizeof(((T *)0)->f)})
+
+// A Columnar (Struct-of-Arrays) Paged Container.
+// Each field is stored in its own List. All columns share one page
+// geometry (rows per page), so row 'i' sits at the same page and slot in
+// every column and a row range is one contiguous span per column.
+typedef struct {
+	Arena *source;
+	FrameColumn *schema;
+	List *columns;
+	u32 width;
+	u64 rows;
+	Result status; // Creation result
+} Frame;
+
+// A walk over a Frame one row range (part of one page) at a time. After
+// each successful frame.next(), rows [at, at + len) are contiguous in every
+// column (see frame.span).
+typedef struct {
+	Frame *frame;
+	u64 at;
+	u64 len;
+	u64 next;
+} FrameCursor;
+
+// --- NAMESPACE ---
+
+typedef struct {
+	/*
+	 * INTENT: Creates a frame with one column per schema entry.
+	 * USAGE:
+	 * ```
+	 * FrameColumn cols[] = {FRAME_FIELD(Trade, price), FRAME_FIELD(Trade, qty)};
+	 * Frame trades = frame.create(&ctx, cols, 2);
+	 * ```
+	 * INVARIANTS: Rows per page are sized so the widest column fills about
+	 * LIST_PAGE_BYTES; pages are cache-line aligned.
+	 * FAILURE MODES: Returns status=OOM if the schema or column headers
+	 * cannot be allocated.
+	 */
+	Frame (*create)(Arena *a, const FrameColumn *schema, u32 width);
+
+	/*
+	 * INTENT: Appends a row, scattering each field into its column.
+	 * USAGE:
+	 * ```
+	 * frame.push(&trades, &t);
+	 * ```
+	 * INVARIANTS: All columns always hold exactly 'rows' items.
+	 * FAILURE MODES: Returns false (rows unchanged) on OOM.
+	 */
+	bool (*push)(Frame *f, const void *row);
+
+	/*
+	 * INTENT: Gathers row 'index' back into a row struct.
+	 * USAGE:
+	 * ```
+	 * Trade t;
+	 * frame.get(&trades, 5, &t);
+	 * ```
+	 * INVARIANTS: Bytes of 'out' not covered by the schema are untouched.
+	 * FAILURE MODES: Returns false if index >= rows.
+	 */
+	bool (*get)(Frame *f, u64 index, void *out);
+
+	/*
+	 * INTENT: Returns a pointer to one cell.
+	 * USAGE:
+	 * ```
+	 * f64 *price = frame.cell(&trades, 0, 5);
+	 * ```
+	 * INVARIANTS: Stable for the frame's lifetime (pages never move).
+	 * FAILURE MODES: Returns NULL if the column or row is out of range.
+	 */
+	void *(*cell)(Frame *f, u32 column, u64 index);
+
+	/*
+	 * INTENT: Preallocates every column for 'rows' total rows.
+	 * USAGE:
+	 * ```
+	 * frame.reserve(&trades, 1000000);
+	 * ```
+	 * INVARIANTS: Later pushes up to 'rows' allocate nothing.
+	 * FAILURE MODES: Returns OOM if the Arena cannot hold the pages.
+	 */
+	Result (*reserve)(Frame *f, u64 rows);
+
+	/*
+	 * INTENT: Starts a walk over row ranges beginning at row 'start'.
+	 * USAGE:
+	 * ```
+	 * FrameCursor c = frame.cursor(&trades, 0);
+	 * while (frame.next(&c)) {
+	 *     f64 *price = frame.span(&c, 0);
+	 *     u32 *qty = frame.span(&c, 1);
+	 *     for (u64 i = 0; i < c.len; i++) notional += price[i] * qty[i];
+	 * }
+	 * ```
+	 * INVARIANTS: No range is loaded until the first frame.next().
+	 * FAILURE MODES: A 'start' at or past rows yields no ranges.
+	 */
+	FrameCursor (*cursor)(Frame *f, u64 start);
+
+	/*
+	 * INTENT: Loads the next row range into 'c'.
+	 * USAGE:
+	 * ```
+	 * while (frame.next(&c)) { ... }
+	 * ```
+	 * INVARIANTS: Ranges never cross a page boundary and are never empty.
+	 * FAILURE MODES: Returns false once the walk is exhausted.
+	 */
+	bool (*next)(FrameCursor *c);
+
+	/*
+	 * INTENT: Returns column 'column' of the current row range: 'c->len'
+	 * contiguous values, the first being row 'c->at'.
+	 * USAGE:
+	 * ```
+	 * f64 *price = frame.span(&c, 0);
+	 * ```
+	 * INVARIANTS: Valid after a successful frame.next().
+	 * FAILURE MODES: Returns NULL if the column is out of range.
+	 */
+	void *(*span)(FrameCursor *c, u32 column);
+} FrameNamespace;
+
+extern const FrameNamespace frame;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+#ifndef CAMELOT_HASH_H
+#define CAMELOT_HASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../types/primitives.h"
+#include "../types/string.h"
+
+// --- NAMESPACE ---
+
+typedef struct {
+	/*
+	 * INTENT: Hashes 'len' bytes with a wyhash-style function that reads 8
+	 * bytes at a time and folds them with 64x64->128 multiplies.
+	 * USAGE:
+	 * ```
+	 * u64 h = hash.bytes(&point, sizeof(point), seed);
+	 * ```
+	 * INVARIANTS: Deterministic for a given seed, on any alignment. Not
+	 * cryptographic.
+	 * FAILURE MODES: None.
+	 */
+	u64 (*bytes)(const void *data, u64 len, u64 seed);
+
+	/*
+	 * INTENT: Hashes the bytes of a String view.
+	 * USAGE:
+	 * ```
+	 * u64 h = hash.str(name, seed);
+	 * ```
+	 * INVARIANTS: Equal to hash.bytes(s.ptr, s.len, seed).
+	 * FAILURE MODES: None.
+	 */
+	u64 (*str)(String s, u64 seed);
+
+	/*
+	 * INTENT: Mixes a single 64-bit integer (ids, pointers) in two multiplies.
+	 * USAGE:
+	 * ```
+	 * u64 h = hash.word(user_id, seed);
+	 * ```
+	 * INVARIANTS: Every input bit affects every output bit.
+	 * FAILURE MODES: None.
+	 */
+	u64 (*word)(u64 x, u64 seed);
+
+	/*
+	 * INTENT: Returns a fresh seed so that each table hashes differently,
+	 * which makes hash-flooding inputs hard to precompute.
+	 * USAGE:
+	 * ```
+	 * u64 seed = hash.seed();
+	 * ```
+	 * INVARIANTS: Keeps no state: mixes 64 bits from getrandom with a clock
+	 * and a stack address, so seeds differ between calls and between runs.
+	 * FAILURE MODES: If getrandom is unavailable the seed rests on the clock
+	 * and address alone: still per-call, but predictable to a local attacker.
+	 */
+	u64 (*seed)(void);
+} HashNamespace;
+
+extern const HashNamespace hash;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
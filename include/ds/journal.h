@@ -0,0 +1,116 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+#ifndef CAMELOT_JOURNAL_H
+#define CAMELOT_JOURNAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "camelot/memory.h"
+#include "ds/list.h"
+
+// A Concurrent Append-Only Paged List.
+// Producers claim indices with one atomic add and publish them in index
+// order; pages are installed into a fixed directory with CAS; readers see
+// the committed prefix. Uses the same page geometry as List and pages never
+// move.
+typedef struct {
+	SharedArena *source;
+	void *_Atomic *pages; // Directory sized for 'capacity' items
+	u64 pages_cap;
+	u64 capacity;
+	u64 item_size;
+	u32 page_shift;
+	u64 page_mask;
+	Result status; // Creation result
+	_Alignas(CACHE_LINE) _Atomic u64 reserved; // Next index handed to a producer
+	_Alignas(CACHE_LINE) _Atomic u64 committed; // Items visible to readers
+	_Atomic u64 sealed; // Index whose page could not be allocated (UINT64_MAX = none)
+} Journal;
+
+// --- NAMESPACE ---
+
+typedef struct {
+	/*
+	 * INTENT: Creates a journal of up to 'capacity' items whose directory
+	 * and pages come from a SharedArena.
+	 * USAGE:
+	 * ```
+	 * SharedArena region = shared.create(1ULL << 30, 0);
+	 * Journal events = journal.create(&region, sizeof(Event), 10000000);
+	 * ```
+	 * INVARIANTS: The directory is allocated up front and never grows.
+	 * Create on one thread, then share by pointer; never copy it afterwards.
+	 * FAILURE MODES: Returns status=OOM if the directory cannot be allocated.
+	 */
+	Journal (*create)(SharedArena *s, u64 item_size, u64 capacity);
+
+	/*
+	 * INTENT: Installs the pages for the first 'n' items ahead of time.
+	 * USAGE:
+	 * ```
+	 * journal.reserve(&events, 1000000);
+	 * ```
+	 * INVARIANTS: Pushes into reserved pages never touch the SharedArena.
+	 * Safe to call concurrently with producers.
+	 * FAILURE MODES: Returns OOM if the region runs out; 'n' past capacity is
+	 * clamped.
+	 */
+	Result (*reserve)(Journal *j, u64 n);
+
+	/*
+	 * INTENT: Appends a copy of the item from any thread.
+	 * USAGE:
+	 * ```
+	 * journal.push(&events, &e);
+	 * ```
+	 * INVARIANTS: Only the claim and the copy are lock-free. Publication is
+	 * in index order and blocking: push returns once every earlier item has
+	 * been published.
+	 * FAILURE MODES: Returns false once capacity is reached. If a page cannot
+	 * be allocated the journal is sealed at that index: 'sealed' records it
+	 * and later pushes fail. A producer descheduled between claim and
+	 * publish stalls every later producer (they spin, then yield) until it
+	 * runs again; push is not lock-free.
+	 */
+	bool (*push)(Journal *j, const void *item);
+
+	/*
+	 * INTENT: Returns the number of published items.
+	 * USAGE:
+	 * ```
+	 * u64 n = journal.count(&events);
+	 * ```
+	 * INVARIANTS: Acquire load: every item below the returned count is fully
+	 * written and visible to the caller.
+	 * FAILURE MODES: None.
+	 */
+	u64 (*count)(Journal *j);
+
+	/*
+	 * INTENT: Retrieves a published item.
+	 * USAGE:
+	 * ```
+	 * Event *e = journal.get(&events, 5);
+	 * ```
+	 * INVARIANTS: Published items are never moved or overwritten.
+	 * FAILURE MODES: Returns NULL if index is not yet published.
+	 */
+	void *(*get)(Journal *j, u64 index);
+} JournalNamespace;
+
+extern const JournalNamespace journal;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
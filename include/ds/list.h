@@ -1,87 +1,572 @@
-/*
- * This Source Code Form is subject to the terms of the Mozilla Public
- * License, v. 2.0. If a copy of the MPL was not distributed with this
- * file, You can obtain one at http://mozilla.org/MPL/2.0/.
- *
- * Governed by the Avant Systems Canon (ASC-1.1).
- * Compliance is mandatory for all contributions.
- */
-
-#ifndef CAMELOT_LIST_H
-#define CAMELOT_LIST_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#include "camelot/memory.h"
-
-#define PAGE_SIZE 256
-
-// A Paged Dynamic Array.
-// Ensures O(1) pointer stability (pointers to elements never invalidate).
-// Grows automatically by allocating new pages from the source Arena.
-typedef struct {
-	Arena *source;
-	void **pages;
-	u64 pages_cap;
-	u64 pages_len;
-	u64 item_size;
-	u64 count;
-} List;
-
-// --- NAMESPACE ---
-
-typedef struct {
-	/*
-	 * INTENT: Initializes a new Paged List on the given Arena.
-	 * USAGE:
-	 * ```
-	 * List ints = list.create(&ctx, sizeof(int));
-	 * ```
-	 * INVARIANTS: List owns no memory until first push.
-	 * FAILURE MODES: Returns valid struct; allocation failures occur on push.
-	 */
-	List (*create)(Arena *a, u64 item_size);
-
-	/*
-	 * INTENT: Appends a copy of the data to the end of the list.
-	 * USAGE:
-	 * ```
-	 * list.push(&ints, &value);
-	 * ```
-	 * INVARIANTS: Pointers to existing elements remain valid (No Realloc).
-	 * FAILURE MODES: Triggers OOM on Arena if page allocation fails.
-	 */
-	void (*push)(List *l, void *item_ptr);
-
-	/*
-	 * INTENT: Retrieves a pointer to the mutable item at index.
-	 * USAGE:
-	 * ```
-	 * int *x = list.get(&ints, 5);
-	 * ```
-	 * INVARIANTS: O(1) access time.
-	 * FAILURE MODES: Returns NULL if index >= count.
-	 */
-	void *(*get)(List *l, u64 index);
-
-	/*
-	 * INTENT: Swap-removes the item at index (unordered removal).
-	 * USAGE:
-	 * ```
-	 * list.remove(&ints, 5);
-	 * ```
-	 * INVARIANTS: Moves the last element into the removed slot.
-	 * FAILURE MODES: No-op if index >= count.
-	 */
-	void (*remove)(List *l, u64 index);
-} ListNamespace;
-
-extern const ListNamespace list;
-
-#ifdef __cplusplus
-}
-#endif
-
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+#ifndef CAMELOT_LIST_H
+#define CAMELOT_LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "camelot/memory.h"
+
+// Default page footprint in bytes (see list.create_paged).
+#define LIST_PAGE_BYTES (16 * 1024)
+
+// Shift of the largest power-of-two count of 'size'-byte items that fits in
+// 'bytes' (at least one item). Constant for constant arguments.
+#define LIST_PAGE_SHIFT_FOR(size, bytes)                                                           \
+	((size) >= (bytes) ? 0u : (u32)(63 - __builtin_clzll((u64)(bytes) / (size))))
+
+// A Paged Dynamic Array.
+// Ensures O(1) pointer stability (pointers to elements never invalidate).
+// Grows automatically by allocating new pages from the source Arena.
+typedef struct {
+	Arena *source;
+	void **pages;
+	u64 pages_cap;
+	u64 pages_len;
+	u64 item_size;
+	u64 count;
+	u32 page_shift; // Items per page is 1 << page_shift
+	u64 page_mask;
+} List;
+
+// A walk over a List one contiguous span (part of one page) at a time.
+// After each successful list.next(), 'ptr' holds 'len' items in memory
+// order, the first of which is item 'at' of the list.
+typedef struct {
+	List *list;
+	void *ptr;
+	u64 len;
+	u64 at;
+	u64 next;
+	bool reverse;
+} ListCursor;
+
+// Upper bound on threads used by the list.parallel_* operations.
+#define LIST_MAX_WORKERS 64
+
+// Callbacks for the list.parallel_* operations. Each call receives one
+// page span: 'len' items in memory order, the first being item 'at'.
+typedef void (*ListSpanFn)(void *items, u64 len, u64 at, void *ctx);
+typedef void (*ListFoldFn)(void *acc, const void *items, u64 len, void *ctx);
+typedef void (*ListMergeFn)(void *acc, const void *part, void *ctx);
+typedef void (*ListMapFn)(void *out, const void *in, u64 len, void *ctx);
+
+// Three-way comparison for list.sort / lower_bound / search: negative,
+// zero or positive as 'a' orders before, with or after 'b'.
+typedef int (*ListCmpFn)(const void *a, const void *b, void *ctx);
+
+// --- NAMESPACE ---
+
+typedef struct {
+	/*
+	 * INTENT: Initializes a new Paged List on the given Arena.
+	 * USAGE:
+	 * ```
+	 * List ints = list.create(&ctx, sizeof(int));
+	 * ```
+	 * INVARIANTS: List owns no memory until first push. Pages are about
+	 * LIST_PAGE_BYTES each.
+	 * FAILURE MODES: Returns valid struct; allocation failures occur on push.
+	 */
+	List (*create)(Arena *a, u64 item_size);
+
+	/*
+	 * INTENT: Like create, with pages of at most 'page_bytes' bytes.
+	 * USAGE:
+	 * ```
+	 * List flags = list.create_paged(&ctx, sizeof(u8), 64 * 1024);
+	 * ```
+	 * INVARIANTS: Items per page is rounded down to a power of two, so
+	 * index math is a shift and a mask. Every page holds at least one item.
+	 * FAILURE MODES: Same as create.
+	 */
+	List (*create_paged)(Arena *a, u64 item_size, u64 page_bytes);
+
+	/*
+	 * INTENT: Appends a copy of the data to the end of the list.
+	 * USAGE:
+	 * ```
+	 * list.push(&ints, &value);
+	 * ```
+	 * INVARIANTS: Pointers to existing elements remain valid (No Realloc).
+	 * FAILURE MODES: Triggers OOM on Arena if page allocation fails.
+	 */
+	void (*push)(List *l, void *item_ptr);
+
+	/*
+	 * INTENT: Appends an uninitialized slot and returns it for construction
+	 * in place.
+	 * USAGE:
+	 * ```
+	 * Row *r = list.push_slot(&rows);
+	 * r->id = 7;
+	 * ```
+	 * INVARIANTS: Slot contents are whatever the page held (zero on fresh
+	 * pages of a zeroing Arena).
+	 * FAILURE MODES: Returns NULL (count unchanged) if page allocation fails.
+	 */
+	void *(*push_slot)(List *l);
+
+	/*
+	 * INTENT: Appends 'n' contiguous items from 'src' with one memcpy per
+	 * page.
+	 * USAGE:
+	 * ```
+	 * list.push_n(&ints, buffer, 1000);
+	 * ```
+	 * INVARIANTS: Order is preserved. Returns the number of items appended.
+	 * FAILURE MODES: Stops early (returning fewer than 'n') on OOM.
+	 */
+	u64 (*push_n)(List *l, const void *src, u64 n);
+
+	/*
+	 * INTENT: Appends every item of 'other' page by page.
+	 * USAGE:
+	 * ```
+	 * list.extend(&all, &batch);
+	 * ```
+	 * INVARIANTS: 'other' is unchanged (or, when it is 'l' itself, doubled
+	 * once). Returns the number of items appended.
+	 * FAILURE MODES: Returns 0 if item sizes differ; stops early on OOM.
+	 */
+	u64 (*extend)(List *l, const List *other);
+
+	/*
+	 * INTENT: Preallocates the directory and pages for 'n' total items.
+	 * USAGE:
+	 * ```
+	 * list.reserve(&ints, 10000000);
+	 * ```
+	 * INVARIANTS: Later pushes up to 'n' items allocate nothing. Count is
+	 * unchanged.
+	 * FAILURE MODES: Returns OOM if the Arena cannot hold the pages; pages
+	 * allocated before the failure are kept.
+	 */
+	Result (*reserve)(List *l, u64 n);
+
+	/*
+	 * INTENT: Retrieves a pointer to the mutable item at index.
+	 * USAGE:
+	 * ```
+	 * int *x = list.get(&ints, 5);
+	 * ```
+	 * INVARIANTS: O(1) access time.
+	 * FAILURE MODES: Returns NULL if index >= count.
+	 */
+	void *(*get)(List *l, u64 index);
+
+	/*
+	 * INTENT: Swap-removes the item at index (unordered removal).
+	 * USAGE:
+	 * ```
+	 * list.remove(&ints, 5);
+	 * ```
+	 * INVARIANTS: Moves the last element into the removed slot.
+	 * FAILURE MODES: No-op if index >= count.
+	 */
+	void (*remove)(List *l, u64 index);
+
+	/*
+	 * INTENT: Removes the last item, copying it to 'out' if not NULL.
+	 * USAGE:
+	 * ```
+	 * int top;
+	 * while (list.pop(&stack, &top)) { ... }
+	 * ```
+	 * INVARIANTS: Pages stay in the directory and are reused by later pushes.
+	 * FAILURE MODES: Returns false (nothing copied) if the list is empty.
+	 */
+	bool (*pop)(List *l, void *out);
+
+	/*
+	 * INTENT: Shrinks the list to its first 'count' items.
+	 * USAGE:
+	 * ```
+	 * list.truncate(&ints, 10);
+	 * ```
+	 * INVARIANTS: Pages past the new end are kept for reuse, so shrink/grow
+	 * cycles allocate nothing once the list has reached its peak size.
+	 * FAILURE MODES: No-op if 'count' is not below the current count.
+	 */
+	void (*truncate)(List *l, u64 count);
+
+	/*
+	 * INTENT: Empties the list, keeping all of its pages for reuse.
+	 * USAGE:
+	 * ```
+	 * list.clear(&batch);
+	 * ```
+	 * INVARIANTS: Equivalent to list.truncate(l, 0). Item contents are not
+	 * scrubbed.
+	 * FAILURE MODES: None.
+	 */
+	void (*clear)(List *l);
+
+	/*
+	 * INTENT: Starts a forward walk over the spans of 'l' beginning at item
+	 * 'start'.
+	 * USAGE:
+	 * ```
+	 * ListCursor c = list.cursor(&ints, 0);
+	 * while (list.next(&c))
+	 *     sum_span(c.ptr, c.len);
+	 * ```
+	 * INVARIANTS: No span is loaded until the first list.next().
+	 * FAILURE MODES: A 'start' at or past count yields no spans.
+	 */
+	ListCursor (*cursor)(List *l, u64 start);
+
+	/*
+	 * INTENT: Starts a backward walk over the spans of 'l' from item 'start'
+	 * (inclusive) down to item 0.
+	 * USAGE:
+	 * ```
+	 * ListCursor c = list.rcursor(&ints, ints.count - 1);
+	 * ```
+	 * INVARIANTS: Spans arrive last page first; each span is still laid out
+	 * in memory order.
+	 * FAILURE MODES: A 'start' past the end is clamped to the last item.
+	 */
+	ListCursor (*rcursor)(List *l, u64 start);
+
+	/*
+	 * INTENT: Loads the next span of the walk into 'c'.
+	 * USAGE:
+	 * ```
+	 * while (list.next(&c)) { ... }
+	 * ```
+	 * INVARIANTS: Spans never cross a page boundary and are never empty.
+	 * FAILURE MODES: Returns false once the walk is exhausted. Pushing or
+	 * removing during a walk is undefined.
+	 */
+	bool (*next)(ListCursor *c);
+
+	/*
+	 * INTENT: Calls 'fn' on every page span of 'l' from up to 'workers'
+	 * threads (0 = one per online CPU).
+	 * USAGE:
+	 * ```
+	 * list.parallel_for(&prices, scale_span, &factor, 0);
+	 * ```
+	 * INVARIANTS: Each span is visited exactly once; spans run in no
+	 * particular order. The calling thread works too and all workers have
+	 * finished on return. Helper threads start on first use and sleep
+	 * between calls, so all parallel_* calls and list.sort share them. One
+	 * call runs at a time: a call made while another is running (from a
+	 * second thread, or from inside 'fn') runs on its caller alone.
+	 * FAILURE MODES: If threads cannot be started, fewer workers (at worst
+	 * only the caller) do the work.
+	 */
+	void (*parallel_for)(List *l, ListSpanFn fn, void *ctx, u32 workers);
+
+	/*
+	 * INTENT: Folds every page span into its own copy of '*acc', then merges
+	 * the per-page results into 'acc' in page order.
+	 * USAGE:
+	 * ```
+	 * f64 total = 0.0; // identity on entry, result on return
+	 * list.parallel_reduce(&prices, &total, sizeof(total), sum_span, add, NULL, 0);
+	 * ```
+	 * INVARIANTS: Deterministic: the fold/merge sequence depends only on the
+	 * list geometry, never on the worker count or scheduling.
+	 * FAILURE MODES: Returns OOM (acc untouched) if the per-page partials do
+	 * not fit in scratch memory.
+	 */
+	Result (*parallel_reduce)(List *l, void *acc, u64 acc_size, ListFoldFn fold,
+							  ListMergeFn merge, void *ctx, u32 workers);
+
+	/*
+	 * INTENT: Appends map(src) to 'dst', converting page spans in parallel.
+	 * USAGE:
+	 * ```
+	 * list.parallel_map(&ids, &rows, row_ids, NULL, 0);
+	 * ```
+	 * INVARIANTS: Item i of 'src' lands at dst index (old count + i). Item
+	 * sizes and page geometries of the two lists may differ.
+	 * FAILURE MODES: Returns OOM (dst count unchanged) if 'dst' cannot
+	 * reserve room for the output.
+	 */
+	Result (*parallel_map)(List *dst, List *src, ListMapFn map, void *ctx, u32 workers);
+
+	/*
+	 * INTENT: Sorts the list in place by 'cmp'. Each page is introsorted,
+	 * then the sorted pages are merged bottom-up.
+	 * USAGE:
+	 * ```
+	 * list.sort(&rows, by_price, NULL, 1); // serial
+	 * list.sort(&rows, by_price, NULL, 0); // one worker per online CPU
+	 * ```
+	 * INVARIANTS: Not stable. Item pointers stay valid (items move, pages
+	 * do not). Page sorts and merge pairs are spread over 'workers' threads.
+	 * Merges go page to page: scratch holds two spare pages per worker and
+	 * five words per page, never a flat copy of the list.
+	 * FAILURE MODES: Returns OOM (list untouched) if that scratch memory
+	 * cannot be allocated.
+	 */
+	Result (*sort)(List *l, ListCmpFn cmp, void *ctx, u32 workers);
+
+	/*
+	 * INTENT: Stable LSD radix sort by an unsigned integer key of
+	 * 'key_size' bytes (1, 2, 4 or 8) at 'key_offset' in each item.
+	 * USAGE:
+	 * ```
+	 * list.radix_sort(&ids, 0, sizeof(u64));
+	 * list.radix_sort(&rows, offsetof(Row, id), sizeof(u32));
+	 * ```
+	 * INVARIANTS: Byte digits shared by every key are skipped, so narrow
+	 * key ranges cost fewer passes. Passes alternate between the pages and
+	 * one flat scratch copy of the list.
+	 * FAILURE MODES: Returns INVALID_KEY for an unsupported key size or a
+	 * key outside the item; OOM (list untouched) if scratch memory cannot
+	 * hold one copy of the list.
+	 */
+	Result (*radix_sort)(List *l, u64 key_offset, u64 key_size);
+
+	/*
+	 * INTENT: Binary search for the first item that does not order before
+	 * 'key'. 'cmp' receives (item, key).
+	 * USAGE:
+	 * ```
+	 * u64 i = list.lower_bound(&ids, &target, cmp_u64, NULL);
+	 * ```
+	 * INVARIANTS: The list must be sorted by a compatible order.
+	 * FAILURE MODES: Returns count if every item orders before 'key'.
+	 */
+	u64 (*lower_bound)(List *l, const void *key, ListCmpFn cmp, void *ctx);
+
+	/*
+	 * INTENT: Binary search for an item equal to 'key'.
+	 * USAGE:
+	 * ```
+	 * Row *r = list.search(&rows, &probe, by_id, NULL);
+	 * ```
+	 * INVARIANTS: Same ordering contract as lower_bound; returns the first
+	 * match.
+	 * FAILURE MODES: Returns NULL if no item compares equal.
+	 */
+	void *(*search)(List *l, const void *key, ListCmpFn cmp, void *ctx);
+} ListNamespace;
+
+extern const ListNamespace list;
+
+// --- ITERATION ---
+
+/*
+ * INTENT: Loops 'it' (a T*) over every item of 'l' span by span, so the
+ * inner loop runs over contiguous memory and can be vectorized.
+ * USAGE:
+ * ```
+ * LIST_FOREACH(int, x, &ints) { sum += *x; }
+ * LIST_FOREACH_FROM(int, x, &ints, 100) { ... }
+ * LIST_FOREACH_REVERSE(int, x, &ints) { ... }
+ * ```
+ * INVARIANTS: 'break' ends the whole walk and 'continue' moves to the next
+ * item, as in a plain loop: 'it##_go' is cleared on entering each span and
+ * set again only when the span runs out, so a break stops the outer loops.
+ * FAILURE MODES: Same as list.next().
+ */
+#define LIST_FOREACH_FROM(T, it, l, start)                                                         \
+	for (bool it##_go = true; it##_go; it##_go = false)                                            \
+		for (ListCursor it##_cur = list.cursor((l), (start)); it##_go && list.next(&it##_cur);)    \
+			for (T *it = (it##_go = false, it##_cur.ptr), *it##_end = it + it##_cur.len;           \
+				 it < it##_end || (it##_go = true, false); it++)
+
+#define LIST_FOREACH(T, it, l) LIST_FOREACH_FROM(T, it, l, 0)
+
+#define LIST_FOREACH_REVERSE(T, it, l)                                                             \
+	for (bool it##_go = true; it##_go; it##_go = false)                                            \
+		for (ListCursor it##_cur = list.rcursor((l), UINT64_MAX);                                  \
+			 it##_go && list.next(&it##_cur);)                                                     \
+			for (T *it##_base = (it##_go = false, it##_cur.ptr), *it = it##_base + it##_cur.len;   \
+				 (it != it##_base && (--it, true)) || (it##_go = true, false);)
+
+// --- TYPED LISTS ---
+
+/*
+ * INTENT: Generates a typed wrapper 'Name' over List with static inline
+ * create/push/get/remove/pop, so the element size and page shift are
+ * compile-time constants and get() compiles to a shift, mask and load.
+ * The wrapper always uses the default LIST_PAGE_BYTES geometry.
+ * USAGE:
+ * ```
+ * LIST_DEFINE(int, IntList)
+ * IntList ints = IntList_create(&ctx);
+ * IntList_push(&ints, 42);
+ * int *x = IntList_get(&ints, 0);
+ * ```
+ * INVARIANTS: Shares the paged layout of List: '.base' can be passed to
+ * any list.* function and both views stay consistent. Only the first push
+ * into a new page leaves the inline path.
+ * FAILURE MODES: Same as the List operations they mirror.
+ */
+#define LIST_DEFINE(T, Name)                                                                       \
+	typedef struct {                                                                               \
+		List base;                                                                                 \
+	} Name;                                                                                        \
+                                                                                                   \
+	enum { Name##_SHIFT = LIST_PAGE_SHIFT_FOR(sizeof(T), LIST_PAGE_BYTES) };                       \
+                                                                                                   \
+	static inline Name Name##_create(Arena *a) {                                                   \
+		return (Name){.base = list.create(a, sizeof(T))};                                          \
+	}                                                                                              \
+                                                                                                   \
+	static inline T *Name##_get(Name *l, u64 index) {                                              \
+		if (index >= l->base.count)                                                                \
+			return NULL;                                                                           \
+		return (T *)l->base.pages[index >> Name##_SHIFT] + (index & ((1ULL << Name##_SHIFT) - 1)); \
+	}                                                                                              \
+                                                                                                   \
+	static inline void Name##_push(Name *l, T value) {                                             \
+		u64 n = l->base.count;                                                                     \
+		T *slot;                                                                                   \
+		if ((n >> Name##_SHIFT) < l->base.pages_len) {                                             \
+			slot = (T *)l->base.pages[n >> Name##_SHIFT] + (n & ((1ULL << Name##_SHIFT) - 1));     \
+			l->base.count = n + 1;                                                                 \
+		} else {                                                                                   \
+			slot = (T *)list.push_slot(&l->base);                                                  \
+			if (!slot)                                                                             \
+				return;                                                                            \
+		}                                                                                          \
+		*slot = value;                                                                             \
+	}                                                                                              \
+                                                                                                   \
+	static inline void Name##_remove(Name *l, u64 index) {                                         \
+		u64 n = l->base.count;                                                                     \
+		if (index >= n)                                                                            \
+			return;                                                                                \
+		*Name##_get(l, index) = *Name##_get(l, n - 1);                                             \
+		l->base.count = n - 1;                                                                     \
+	}                                                                                              \
+                                                                                                   \
+	static inline bool Name##_pop(Name *l, T *out) {                                               \
+		u64 n = l->base.count;                                                                     \
+		if (n == 0)                                                                                \
+			return false;                                                                          \
+		if (out)                                                                                   \
+			*out = *Name##_get(l, n - 1);                                                          \
+		l->base.count = n - 1;                                                                     \
+		return true;                                                                               \
+	}
+
+/*
+ * INTENT: Adds Name_sort and Name_lower_bound to a LIST_DEFINE'd list,
+ * ordered by LESS(a, b) (a function or macro taking two T values), which
+ * the compiler can inline into the introsort instead of calling through a
+ * pointer.
+ * USAGE:
+ * ```
+ * #define INT_LESS(a, b) ((a) < (b))
+ * LIST_DEFINE_SORT(int, IntList, INT_LESS)
+ * IntList_sort(&ints);
+ * u64 i = IntList_lower_bound(&ints, 42);
+ * ```
+ * INVARIANTS: Sorts in place with no allocation (unstable). Serial; use
+ * list.sort on '.base' for the parallel mode.
+ * FAILURE MODES: None.
+ */
+#define LIST_DEFINE_SORT(T, Name, LESS)                                                            \
+	static inline T *Name##_at(Name *l, u64 i) {                                                   \
+		return (T *)l->base.pages[i >> Name##_SHIFT] + (i & ((1ULL << Name##_SHIFT) - 1));         \
+	}                                                                                              \
+                                                                                                   \
+	static inline void Name##_sift(Name *l, u64 lo, u64 root, u64 n) {                             \
+		T v = *Name##_at(l, lo + root);                                                            \
+		for (u64 c; (c = 2 * root + 1) < n; root = c) {                                            \
+			if (c + 1 < n && LESS(*Name##_at(l, lo + c), *Name##_at(l, lo + c + 1)))               \
+				c++;                                                                               \
+			if (!LESS(v, *Name##_at(l, lo + c)))                                                   \
+				break;                                                                             \
+			*Name##_at(l, lo + root) = *Name##_at(l, lo + c);                                      \
+		}                                                                                          \
+		*Name##_at(l, lo + root) = v;                                                              \
+	}                                                                                              \
+                                                                                                   \
+	static inline void Name##_swap(T *a, T *b) {                                                   \
+		T t = *a;                                                                                  \
+		*a = *b;                                                                                   \
+		*b = t;                                                                                    \
+	}                                                                                              \
+                                                                                                   \
+	static inline void Name##_sort_range(Name *l, u64 lo, u64 n, u32 depth) {                      \
+		while (n > 16) {                                                                           \
+			if (depth-- == 0) {                                                                    \
+				for (u64 i = n / 2; i-- > 0;)                                                      \
+					Name##_sift(l, lo, i, n);                                                      \
+				for (u64 end = n; end-- > 1;) {                                                    \
+					Name##_swap(Name##_at(l, lo), Name##_at(l, lo + end));                         \
+					Name##_sift(l, lo, 0, end);                                                    \
+				}                                                                                  \
+				return;                                                                            \
+			}                                                                                      \
+			T *a = Name##_at(l, lo), *m = Name##_at(l, lo + n / 2), *z = Name##_at(l, lo + n - 1); \
+			if (LESS(*m, *a))                                                                      \
+				Name##_swap(m, a);                                                                 \
+			if (LESS(*z, *m)) {                                                                    \
+				Name##_swap(z, m);                                                                 \
+				if (LESS(*m, *a))                                                                  \
+					Name##_swap(m, a);                                                             \
+			}                                                                                      \
+			T *p = Name##_at(l, lo + 1);                                                           \
+			Name##_swap(m, p);                                                                     \
+			T pivot = *p;                                                                          \
+			u64 i = 1, j = n - 1;                                                                  \
+			for (;;) {                                                                             \
+				while (LESS(*Name##_at(l, lo + ++i), pivot)) {                                     \
+				}                                                                                  \
+				while (LESS(pivot, *Name##_at(l, lo + --j))) {                                     \
+				}                                                                                  \
+				if (i >= j)                                                                        \
+					break;                                                                         \
+				Name##_swap(Name##_at(l, lo + i), Name##_at(l, lo + j));                           \
+			}                                                                                      \
+			Name##_swap(p, Name##_at(l, lo + j));                                                  \
+			if (j < n - j - 1) {                                                                   \
+				Name##_sort_range(l, lo, j, depth);                                                \
+				lo += j + 1;                                                                       \
+				n -= j + 1;                                                                        \
+			} else {                                                                               \
+				Name##_sort_range(l, lo + j + 1, n - j - 1, depth);                                \
+				n = j;                                                                             \
+			}                                                                                      \
+		}                                                                                          \
+		for (u64 i = 1; i < n; i++) {                                                              \
+			T v = *Name##_at(l, lo + i);                                                           \
+			u64 k = i;                                                                             \
+			for (; k > 0 && LESS(v, *Name##_at(l, lo + k - 1)); k--)                               \
+				*Name##_at(l, lo + k) = *Name##_at(l, lo + k - 1);                                 \
+			*Name##_at(l, lo + k) = v;                                                             \
+		}                                                                                          \
+	}                                                                                              \
+                                                                                                   \
+	static inline void Name##_sort(Name *l) {                                                      \
+		u64 n = l->base.count;                                                                     \
+		if (n > 1)                                                                                 \
+			Name##_sort_range(l, 0, n, 2 * (64 - __builtin_clzll(n)));                             \
+	}                                                                                              \
+                                                                                                   \
+	static inline u64 Name##_lower_bound(Name *l, T key) {                                         \
+		u64 lo = 0, hi = l->base.count;                                                            \
+		while (lo < hi) {                                                                          \
+			u64 mid = lo + (hi - lo) / 2;                                                          \
+			if (LESS(*Name##_at(l, mid), key))                                                     \
+				lo = mid + 1;                                                                      \
+			else                                                                                   \
+				hi = mid;                                                                          \
+		}                                                                                          \
+		return lo;                                                                                 \
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+#ifndef CAMELOT_QUEUE_H
+#define CAMELOT_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "camelot/memory.h"
+
+// A Bounded Single-Producer Single-Consumer Ring.
+// Each side owns one cache line: its own index plus a cached copy of the
+// other side's index, so the shared line is only read when the cache says
+// the ring looks full (producer) or empty (consumer).
+typedef struct {
+	u8 *slots;
+	u64 mask; // Capacity - 1 (capacity is a power of two)
+	u64 item_size;
+	Result status; // Creation result
+	_Alignas(CACHE_LINE) _Atomic u64 head; // Consumer position
+	u64 tail_cache;
+	_Alignas(CACHE_LINE) _Atomic u64 tail; // Producer position
+	u64 head_cache;
+} Ring;
+
+// A Bounded Multi-Producer Multi-Consumer Queue (Vyukov's sequenced ring).
+// Every cell carries a sequence number that tells producers and consumers
+// whose turn it is; head and tail live on separate cache lines.
+typedef struct {
+	u8 *cells;
+	u64 mask;
+	u64 item_size;
+	u64 stride; // Bytes per cell (sequence + item, 8-aligned)
+	Result status;
+	_Alignas(CACHE_LINE) _Atomic u64 head; // Next position to dequeue
+	_Alignas(CACHE_LINE) _Atomic u64 tail; // Next position to enqueue
+} Queue;
+
+// --- NAMESPACE ---
+
+typedef struct {
+	/*
+	 * INTENT: Creates a ring of at least 'capacity' items on the Arena.
+	 * USAGE:
+	 * ```
+	 * Ring pipe = ring.create(&ctx, sizeof(Msg), 1024);
+	 * ```
+	 * INVARIANTS: Capacity is rounded up to a power of two. Create on one
+	 * thread, then share by pointer; never copy it afterwards.
+	 * FAILURE MODES: Returns status=OOM if the slots cannot be allocated.
+	 */
+	Ring (*create)(Arena *a, u64 item_size, u64 capacity);
+
+	/*
+	 * INTENT: Enqueues a copy of the item (producer thread only).
+	 * USAGE:
+	 * ```
+	 * while (!ring.push(&pipe, &msg)) { ... }
+	 * ```
+	 * INVARIANTS: Wait-free. The item is visible to the consumer once this
+	 * returns true.
+	 * FAILURE MODES: Returns false if the ring is full.
+	 */
+	bool (*push)(Ring *r, const void *item);
+
+	/*
+	 * INTENT: Dequeues the oldest item into 'out' (consumer thread only).
+	 * USAGE:
+	 * ```
+	 * Msg msg;
+	 * if (ring.pop(&pipe, &msg)) { ... }
+	 * ```
+	 * INVARIANTS: Wait-free; FIFO.
+	 * FAILURE MODES: Returns false if the ring is empty.
+	 */
+	bool (*pop)(Ring *r, void *out);
+} RingNamespace;
+
+typedef struct {
+	/*
+	 * INTENT: Creates a queue of at least 'capacity' items on the Arena.
+	 * USAGE:
+	 * ```
+	 * Queue work = queue.create(&ctx, sizeof(Task), 4096);
+	 * ```
+	 * INVARIANTS: Capacity is rounded up to a power of two. Create on one
+	 * thread, then share by pointer; never copy it afterwards.
+	 * FAILURE MODES: Returns status=OOM if the cells cannot be allocated.
+	 */
+	Queue (*create)(Arena *a, u64 item_size, u64 capacity);
+
+	/*
+	 * INTENT: Enqueues a copy of the item from any thread.
+	 * USAGE:
+	 * ```
+	 * queue.push(&work, &task);
+	 * ```
+	 * INVARIANTS: Lock-free (one CAS on the tail per attempt).
+	 * FAILURE MODES: Returns false if the queue is full.
+	 */
+	bool (*push)(Queue *q, const void *item);
+
+	/*
+	 * INTENT: Dequeues an item into 'out' from any thread.
+	 * USAGE:
+	 * ```
+	 * Task t;
+	 * while (queue.pop(&work, &t)) { ... }
+	 * ```
+	 * INVARIANTS: Lock-free. FIFO per producer.
+	 * FAILURE MODES: Returns false if the queue is empty.
+	 */
+	bool (*pop)(Queue *q, void *out);
+} QueueNamespace;
+
+extern const RingNamespace ring;
+extern const QueueNamespace queue;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
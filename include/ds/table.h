@@ -1,76 +1,97 @@
-/*
- * This Source Code Form is subject to the terms of the Mozilla Public
- * License, v. 2.0. If a copy of the MPL was not distributed with this
- * file, You can obtain one at http://mozilla.org/MPL/2.0/.
- *
- * Governed by the Avant Systems Canon (ASC-1.1).
- * Compliance is mandatory for all contributions.
- */
-
-#ifndef CAMELOT_TABLE_H
-#define CAMELOT_TABLE_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#include "../camelot/memory.h"
-#include "../types/string.h"
-
-typedef struct {
-	String key;
-	void *value;
-	bool alive;
-} Entry;
-
-typedef struct {
-	Arena *source;
-	Entry *entries;
-	u64 cap;
-	u64 count;
-} Table;
-
-// --- NAMESPACE ---
-
-typedef struct {
-	/*
-	 * INTENT: Creates a Hash Table with Linear Probing.
-	 * USAGE:
-	 * ```
-	 * Table config = table.create(&ctx, 64);
-	 * ```
-	 * INVARIANTS: Capacity is at least 16.
-	 * FAILURE MODES: Returns empty/valid struct (alloc happens on creation).
-	 */
-	Table (*create)(Arena *a, u64 capacity);
-
-	/*
-	 * INTENT: Maps a String key to a value pointer. Overwrites if exists.
-	 * USAGE:
-	 * ```
-	 * table.put(&config, string.from("Key"), &value);
-	 * ```
-	 * INVARIANTS: Auto-resizes if load factor > 0.75.
-	 * FAILURE MODES: Triggers OOM if resize fails.
-	 */
-	void (*put)(Table *t, String key, void *value);
-
-	/*
-	 * INTENT: Retrieves the value pointer associated with the key.
-	 * USAGE:
-	 * ```
-	 * int *val = table.get(&config, string.from("Key"));
-	 * ```
-	 * INVARIANTS: O(1) average case lookup.
-	 * FAILURE MODES: Returns NULL if key not found.
-	 */
-	void *(*get)(Table *t, String key);
-} TableNamespace;
-
-extern const TableNamespace table;
-
-#ifdef __cplusplus
-}
-#endif
-
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+#ifndef CAMELOT_TABLE_H
+#define CAMELOT_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../camelot/memory.h"
+#include "../types/string.h"
+
+// Slots are probed in groups of this many control bytes.
+#define TABLE_GROUP 16
+
+typedef struct {
+	String key;
+	void *value;
+	u64 hash; // Full hash of 'key', reused by probes and resize
+} Entry;
+
+// A Swiss-style open-addressing table. Each slot has one control byte:
+// 0x80 when empty, else the low 7 bits of the key's hash. Lookups compare
+// a whole group of control bytes at once and only touch entries whose
+// byte matches. 'ctrl' holds cap + TABLE_GROUP bytes; the tail mirrors the
+// first group so a group load never wraps.
+typedef struct {
+	Arena *source;
+	Entry *entries;
+	u8 *ctrl; // Lives in the same block, right after 'entries'
+	u64 cap;  // Power of two
+	u64 count;
+	u64 seed; // Per-table hash seed (see hash.seed)
+} Table;
+
+// --- NAMESPACE ---
+
+typedef struct {
+	/*
+	 * INTENT: Creates a Swiss-style hash table probed a group of control
+	 * bytes at a time.
+	 * USAGE:
+	 * ```
+	 * Table config = table.create(&ctx, 64);
+	 * ```
+	 * INVARIANTS: Capacity is rounded up to a power of two, at least 16.
+	 * Entries and control bytes share one cache-line-aligned block of
+	 * cap * (sizeof(Entry) + 1) + TABLE_GROUP bytes. Each table draws its
+	 * own hash seed.
+	 * FAILURE MODES: entries=NULL (and source->status=OOM) if the block
+	 * cannot be allocated; put and get are then no-ops.
+	 */
+	Table (*create)(Arena *a, u64 capacity);
+
+	/*
+	 * INTENT: Maps a String key to a value pointer. Overwrites if exists.
+	 * USAGE:
+	 * ```
+	 * table.put(&config, string.from("Key"), &value);
+	 * ```
+	 * INVARIANTS: Doubles capacity before the load factor would exceed 0.875
+	 * (7/8). Growth copies the block to scratch, grows it with arena.extend
+	 * (in place when it is the Arena's last allocation), and re-places
+	 * entries by their stored hash without rehashing keys.
+	 * FAILURE MODES: If growth fails (source->status=OOM), the table keeps
+	 * its old block and the key is still inserted while a slot is free.
+	 */
+	void (*put)(Table *t, String key, void *value);
+
+	/*
+	 * INTENT: Retrieves the value pointer associated with the key.
+	 * USAGE:
+	 * ```
+	 * int *val = table.get(&config, string.from("Key"));
+	 * ```
+	 * INVARIANTS: O(1) average: each step compares TABLE_GROUP control bytes
+	 * at once, and only entries whose 7-bit tag and stored hash match reach
+	 * string.equal. Probing stops at the first group with an empty slot.
+	 * FAILURE MODES: Returns NULL if key not found.
+	 */
+	void *(*get)(Table *t, String key);
+} TableNamespace;
+
+extern const TableNamespace table;
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -49,6 +49,21 @@ typedef struct {
 	 */
 	String (*join)(Arena *a, String s1, String s2);
 
+	/*
+	 * INTENT: Builder-style concatenation: appends 'tail' to 's', growing it
+	 * in place when 's' is the most recent allocation on the Arena.
+	 * USAGE:
+	 * ```
+	 * String out = string.from("");
+	 * out = string.append(&ctx, out, part);
+	 * ```
+	 * INVARIANTS: Result is null-terminated. Repeated appends to the same
+	 * builder use O(total) arena space instead of O(n^2). The input view is
+	 * consumed: use the returned String afterwards.
+	 * FAILURE MODES: Returns empty string on OOM.
+	 */
+	String (*append)(Arena *a, String s, String tail);
+
 	/*
 	 * INTENT: Compares two strings for byte-wise equality.
 	 * USAGE:
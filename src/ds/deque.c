@@ -0,0 +1,150 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <string.h>
+#include "camelot.h"
+// clang-format on
+
+#define DEQUE_INITIAL_PAGES 4
+
+// --- HELPERS ---
+
+static inline u64 ring_slots(const Deque *d) {
+	return d->pages_cap << d->page_shift;
+}
+
+static inline u8 *slot_at(const Deque *d, u64 slot) {
+	return (u8 *)d->pages[slot >> d->page_shift] + (slot & d->page_mask) * d->item_size;
+}
+
+// Makes sure the page holding ring slot 'slot' exists.
+static bool ensure_page(Deque *d, u64 slot) {
+	void **page = &d->pages[slot >> d->page_shift];
+	if (!*page)
+		*page = arena.alloc_aligned(d->source, d->item_size << d->page_shift, CACHE_LINE);
+	return *page != NULL;
+}
+
+// Doubles a full ring. Pages are laid out again in logical order starting
+// from the front page. When the front item sits mid-page, that page also
+// holds the last items of the ring. Those items are copied into the first
+// new page, so the ring keeps them in order.
+static bool grow(Deque *d) {
+	u64 cap = d->pages_cap;
+	if (cap == 0)
+		return false;
+	void **dir = arena.alloc(d->source, sizeof(void *) * cap * 2);
+	if (!dir)
+		return false;
+	memset(dir, 0, sizeof(void *) * cap * 2);
+
+	u64 first = d->head >> d->page_shift;
+	for (u64 p = 0; p < cap; p++) {
+		dir[p] = d->pages[(first + p) & (cap - 1)];
+	}
+
+	u64 split = d->head & d->page_mask;
+	if (split) {
+		dir[cap] = arena.alloc_aligned(d->source, d->item_size << d->page_shift, CACHE_LINE);
+		if (!dir[cap])
+			return false;
+		memcpy(dir[cap], dir[0], split * d->item_size);
+	}
+
+	d->pages = dir;
+	d->pages_cap = cap * 2;
+	d->head = split;
+	return true;
+}
+
+// --- INTERNAL IMPLEMENTATION ---
+
+static Deque internal_create(Arena *a, u64 item_size) {
+	void **dir = arena.alloc(a, sizeof(void *) * DEQUE_INITIAL_PAGES);
+	if (dir)
+		memset(dir, 0, sizeof(void *) * DEQUE_INITIAL_PAGES);
+	u32 shift = LIST_PAGE_SHIFT_FOR(item_size ? item_size : 1, LIST_PAGE_BYTES);
+
+	return (Deque){
+		.source = a,
+		.pages = dir,
+		.pages_cap = dir ? DEQUE_INITIAL_PAGES : 0,
+		.item_size = item_size,
+		.page_shift = shift,
+		.page_mask = (1ULL << shift) - 1,
+	};
+}
+
+static bool internal_push_back(Deque *d, const void *item) {
+	if (d->count == ring_slots(d) && !grow(d))
+		return false;
+
+	u64 slot = (d->head + d->count) & (ring_slots(d) - 1);
+	if (!ensure_page(d, slot))
+		return false;
+	memcpy(slot_at(d, slot), item, d->item_size);
+	d->count++;
+	return true;
+}
+
+static bool internal_push_front(Deque *d, const void *item) {
+	if (d->count == ring_slots(d) && !grow(d))
+		return false;
+
+	u64 slot = (d->head - 1) & (ring_slots(d) - 1);
+	if (!ensure_page(d, slot))
+		return false;
+	memcpy(slot_at(d, slot), item, d->item_size);
+	d->head = slot;
+	d->count++;
+	return true;
+}
+
+static bool internal_pop_front(Deque *d, void *out) {
+	if (d->count == 0)
+		return false;
+	if (out)
+		memcpy(out, slot_at(d, d->head), d->item_size);
+	d->head = (d->head + 1) & (ring_slots(d) - 1);
+	d->count--;
+	return true;
+}
+
+static bool internal_pop_back(Deque *d, void *out) {
+	if (d->count == 0)
+		return false;
+	d->count--;
+	if (out)
+		memcpy(out, slot_at(d, (d->head + d->count) & (ring_slots(d) - 1)), d->item_size);
+	return true;
+}
+
+static void *internal_get(Deque *d, u64 index) {
+	if (index >= d->count)
+		return NULL;
+	return slot_at(d, (d->head + index) & (ring_slots(d) - 1));
+}
+
+static void internal_clear(Deque *d) {
+	d->head = 0;
+	d->count = 0;
+}
+
+// --- NAMESPACE ---
+
+const DequeNamespace deque = {
+	.create = internal_create,
+	.push_back = internal_push_back,
+	.push_front = internal_push_front,
+	.pop_front = internal_pop_front,
+	.pop_back = internal_pop_back,
+	.get = internal_get,
+	.clear = internal_clear,
+};
@@ -0,0 +1,129 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <string.h>
+#include "camelot.h"
+// clang-format on
+
+// --- HELPERS ---
+
+static inline u8 *cell_at(const List *col, u64 index) {
+	return (u8 *)col->pages[index >> col->page_shift] + (index & col->page_mask) * col->item_size;
+}
+
+// --- INTERNAL IMPLEMENTATION ---
+
+static Frame internal_create(Arena *a, const FrameColumn *schema, u32 width) {
+	FrameColumn *copy = arena.alloc(a, sizeof(FrameColumn) * width);
+	List *columns = arena.alloc(a, sizeof(List) * width);
+	if (!copy || !columns)
+		return (Frame){.source = a, .status = OOM};
+	memcpy(copy, schema, sizeof(FrameColumn) * width);
+
+	// The widest column decides rows per page; the others get pages just
+	// big enough for the same row count.
+	u64 widest = 1;
+	for (u32 c = 0; c < width; c++) {
+		if (schema[c].size > widest)
+			widest = schema[c].size;
+	}
+	u32 shift = LIST_PAGE_SHIFT_FOR(widest, LIST_PAGE_BYTES);
+	for (u32 c = 0; c < width; c++) {
+		u64 size = schema[c].size ? schema[c].size : 1;
+		columns[c] = list.create_paged(a, size, size << shift);
+	}
+
+	return (Frame){
+		.source = a,
+		.schema = copy,
+		.columns = columns,
+		.width = width,
+		.rows = 0,
+		.status = OK,
+	};
+}
+
+static bool internal_push(Frame *f, const void *row) {
+	const u8 *src = row;
+	for (u32 c = 0; c < f->width; c++) {
+		u8 *slot = list.push_slot(&f->columns[c]);
+		if (!slot) {
+			// Keep the columns in lockstep with 'rows'.
+			for (u32 k = 0; k < c; k++) {
+				list.truncate(&f->columns[k], f->rows);
+			}
+			return false;
+		}
+		memcpy(slot, src + f->schema[c].offset, f->schema[c].size);
+	}
+	f->rows++;
+	return true;
+}
+
+static bool internal_get(Frame *f, u64 index, void *out) {
+	if (index >= f->rows)
+		return false;
+	u8 *dst = out;
+	for (u32 c = 0; c < f->width; c++) {
+		memcpy(dst + f->schema[c].offset, cell_at(&f->columns[c], index), f->schema[c].size);
+	}
+	return true;
+}
+
+static void *internal_cell(Frame *f, u32 column, u64 index) {
+	if (column >= f->width || index >= f->rows)
+		return NULL;
+	return cell_at(&f->columns[column], index);
+}
+
+static Result internal_reserve(Frame *f, u64 rows) {
+	for (u32 c = 0; c < f->width; c++) {
+		if (list.reserve(&f->columns[c], rows) != OK)
+			return OOM;
+	}
+	return OK;
+}
+
+static FrameCursor internal_cursor(Frame *f, u64 start) {
+	return (FrameCursor){.frame = f, .next = start};
+}
+
+static bool internal_next(FrameCursor *c) {
+	Frame *f = c->frame;
+	if (f->width == 0 || c->next >= f->rows)
+		return false;
+
+	const List *geometry = &f->columns[0];
+	c->at = c->next;
+	c->len = (geometry->page_mask + 1) - (c->at & geometry->page_mask);
+	if (c->len > f->rows - c->at)
+		c->len = f->rows - c->at;
+	c->next += c->len;
+	return true;
+}
+
+static void *internal_span(FrameCursor *c, u32 column) {
+	if (column >= c->frame->width)
+		return NULL;
+	return cell_at(&c->frame->columns[column], c->at);
+}
+
+// --- NAMESPACE ---
+
+const FrameNamespace frame = {
+	.create = internal_create,
+	.push = internal_push,
+	.get = internal_get,
+	.cell = internal_cell,
+	.reserve = internal_reserve,
+	.cursor = internal_cursor,
+	.next = internal_next,
+	.span = internal_span,
+};
@@ -0,0 +1,121 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+#define _DEFAULT_SOURCE // clock_gettime
+
+// clang-format off
+#include <stdint.h>
+#include <string.h>
+#include <sys/random.h> // getrandom
+#include <time.h>
+#include "camelot.h"
+// clang-format on
+
+// --- CONSTANTS ---
+#define HASH_S0 0xa0761d6478bd642fULL
+#define HASH_S1 0xe7037ed1a0b428dbULL
+#define HASH_S2 0x8ebc6af09c88c6e3ULL
+#define HASH_S3 0x589965cc75374cc3ULL
+
+// --- HELPERS ---
+
+// Folds the 128-bit product of a and b down to 64 bits.
+static inline u64 mix(u64 a, u64 b) {
+	__uint128_t r = (__uint128_t)a * b;
+	return (u64)r ^ (u64)(r >> 64);
+}
+
+static inline u64 read8(const u8 *p) {
+	u64 v;
+	memcpy(&v, p, 8);
+	return v;
+}
+
+static inline u64 read4(const u8 *p) {
+	u32 v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+// --- INTERNAL IMPLEMENTATION ---
+
+static u64 internal_bytes(const void *data, u64 len, u64 seed) {
+	const u8 *p = data;
+	u64 a, b;
+	seed ^= mix(seed ^ HASH_S0, HASH_S1);
+
+	if (len <= 16) {
+		if (len >= 4) {
+			// Two overlapping 4-byte reads from each end cover 4..16 bytes.
+			u64 step = (len >> 3) << 2;
+			a = (read4(p) << 32) | read4(p + step);
+			b = (read4(p + len - 4) << 32) | read4(p + len - 4 - step);
+		} else if (len > 0) {
+			a = ((u64)p[0] << 16) | ((u64)p[len >> 1] << 8) | p[len - 1];
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		u64 i = len;
+		if (i > 48) {
+			// Three independent lanes keep the multipliers busy.
+			u64 lane1 = seed, lane2 = seed;
+			do {
+				seed = mix(read8(p) ^ HASH_S1, read8(p + 8) ^ seed);
+				lane1 = mix(read8(p + 16) ^ HASH_S2, read8(p + 24) ^ lane1);
+				lane2 = mix(read8(p + 32) ^ HASH_S3, read8(p + 40) ^ lane2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= lane1 ^ lane2;
+		}
+		while (i > 16) {
+			seed = mix(read8(p) ^ HASH_S1, read8(p + 8) ^ seed);
+			p += 16;
+			i -= 16;
+		}
+		a = read8(p + i - 16);
+		b = read8(p + i - 8);
+	}
+
+	__uint128_t r = (__uint128_t)(a ^ HASH_S1) * (b ^ seed);
+	return mix((u64)r ^ HASH_S0 ^ len, (u64)(r >> 64) ^ HASH_S1);
+}
+
+static u64 internal_str(String s, u64 seed) {
+	return internal_bytes(s.ptr, s.len, seed);
+}
+
+static u64 internal_word(u64 x, u64 seed) {
+	return mix(mix(x ^ HASH_S0, seed ^ HASH_S1), HASH_S2);
+}
+
+// Stateless: entropy comes from the kernel, with the clock and the stack
+// address mixed in so a failed getrandom still yields a usable seed.
+static u64 internal_seed(void) {
+	u64 entropy = 0;
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	if (getrandom(&entropy, sizeof(entropy), GRND_NONBLOCK) != sizeof(entropy))
+		entropy = 0;
+
+	u64 where = (u64)(uintptr_t)&ts;
+	u64 when = (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
+	return mix(where ^ HASH_S2, mix(when ^ HASH_S3, entropy ^ HASH_S0));
+}
+
+// --- NAMESPACE ---
+
+const HashNamespace hash = {
+	.bytes = internal_bytes,
+	.str = internal_str,
+	.word = internal_word,
+	.seed = internal_seed,
+};
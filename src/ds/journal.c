@@ -0,0 +1,126 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <sched.h> // sched_yield
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include "camelot.h"
+// clang-format on
+
+#define JOURNAL_SPINS 64 // Busy polls before yielding while waiting to publish
+
+// --- HELPERS ---
+
+// Returns page 'p', installing a fresh one if it is still missing. A
+// producer that loses the install race leaves its page unused in the region.
+static void *page_for(Journal *j, u64 p) {
+	void *page = atomic_load_explicit(&j->pages[p], memory_order_acquire);
+	if (page)
+		return page;
+
+	void *fresh = shared.alloc(j->source, j->item_size << j->page_shift);
+	if (!fresh)
+		return NULL;
+	if (atomic_compare_exchange_strong_explicit(&j->pages[p], &page, fresh, memory_order_acq_rel,
+												memory_order_acquire))
+		return fresh;
+	return page;
+}
+
+// Lowers 'sealed' to 'index' (several producers may fail at once).
+static void seal(Journal *j, u64 index) {
+	u64 cur = atomic_load_explicit(&j->sealed, memory_order_relaxed);
+	while (index < cur && !atomic_compare_exchange_weak_explicit(&j->sealed, &cur, index,
+																 memory_order_relaxed,
+																 memory_order_relaxed)) {
+	}
+}
+
+// --- INTERNAL IMPLEMENTATION ---
+
+static Journal internal_create(SharedArena *s, u64 item_size, u64 capacity) {
+	u32 shift = LIST_PAGE_SHIFT_FOR(item_size ? item_size : 1, LIST_PAGE_BYTES);
+	u64 pages_cap = (capacity + (1ULL << shift) - 1) >> shift;
+
+	// Fresh region memory is zero, so every directory slot starts empty.
+	void *_Atomic *dir = shared.alloc(s, pages_cap * sizeof(void *));
+
+	Journal j = {
+		.source = s,
+		.pages = dir,
+		.pages_cap = dir ? pages_cap : 0,
+		.capacity = dir ? capacity : 0,
+		.item_size = item_size,
+		.page_shift = shift,
+		.page_mask = (1ULL << shift) - 1,
+		.status = dir ? OK : OOM,
+	};
+	atomic_init(&j.reserved, 0);
+	atomic_init(&j.committed, 0);
+	atomic_init(&j.sealed, UINT64_MAX);
+	return j;
+}
+
+static Result internal_reserve(Journal *j, u64 n) {
+	if (n > j->capacity)
+		n = j->capacity;
+	u64 pages = (n + j->page_mask) >> j->page_shift;
+	for (u64 p = 0; p < pages; p++) {
+		if (!page_for(j, p))
+			return OOM;
+	}
+	return OK;
+}
+
+static bool internal_push(Journal *j, const void *item) {
+	u64 i = atomic_fetch_add_explicit(&j->reserved, 1, memory_order_relaxed);
+	if (i >= j->capacity)
+		return false;
+
+	u8 *page = page_for(j, i >> j->page_shift);
+	if (!page) {
+		seal(j, i);
+		return false;
+	}
+	memcpy(page + (i & j->page_mask) * j->item_size, item, j->item_size);
+
+	// Publish in index order. The acquire here chains each producer's
+	// writes into the next release, so readers see the whole prefix.
+	for (u32 spins = 0; atomic_load_explicit(&j->committed, memory_order_acquire) != i; spins++) {
+		if (i > atomic_load_explicit(&j->sealed, memory_order_relaxed))
+			return false;
+		if (spins >= JOURNAL_SPINS)
+			sched_yield();
+	}
+	atomic_store_explicit(&j->committed, i + 1, memory_order_release);
+	return true;
+}
+
+static u64 internal_count(Journal *j) {
+	return atomic_load_explicit(&j->committed, memory_order_acquire);
+}
+
+static void *internal_get(Journal *j, u64 index) {
+	if (index >= internal_count(j))
+		return NULL;
+	u8 *page = atomic_load_explicit(&j->pages[index >> j->page_shift], memory_order_relaxed);
+	return page + (index & j->page_mask) * j->item_size;
+}
+
+// --- NAMESPACE ---
+
+const JournalNamespace journal = {
+	.create = internal_create,
+	.reserve = internal_reserve,
+	.push = internal_push,
+	.count = internal_count,
+	.get = internal_get,
+};
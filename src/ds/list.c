@@ -1,89 +1,251 @@
-/*
- * This Source Code Form is subject to the terms of the Mozilla Public
- * License, v. 2.0. If a copy of the MPL was not distributed with this
- * file, You can obtain one at http://mozilla.org/MPL/2.0/.
- *
- * Governed by the Avant Systems Canon (ASC-1.1).
- * Compliance is mandatory for all contributions.
- */
-
-// clang-format off
-#include <string.h>
-#include "camelot.h"
-// clang-format on
-
-// --- INTERNAL IMPLEMENTATION ---
-
-static List internal_create(Arena *a, u64 item_size) {
-	u64 initial_cap = 16;
-	void **dir = arena.alloc(a, sizeof(void *) * initial_cap);
-
-	return (List){
-		.source = a,
-		.pages = dir,
-		.pages_cap = initial_cap,
-		.pages_len = 0,
-		.item_size = item_size,
-		.count = 0,
-	};
-}
-
-static void ensure_directory(List *l) {
-	if (l->pages_len < l->pages_cap)
-		return;
-
-	u64 new_cap = l->pages_cap * 2;
-	void **new_dir = arena.alloc(l->source, sizeof(void *) * new_cap);
-
-	if (l->pages) {
-		memcpy(new_dir, l->pages, sizeof(void *) * l->pages_cap);
-	}
-	l->pages = new_dir;
-	l->pages_cap = new_cap;
-}
-
-static void internal_push(List *l, void *item_ptr) {
-	u64 page_idx = l->count / PAGE_SIZE;
-	u64 item_idx = l->count % PAGE_SIZE;
-
-	if (item_idx == 0) {
-		ensure_directory(l);
-		void *new_page = arena.alloc(l->source, l->item_size * PAGE_SIZE);
-		l->pages[page_idx] = new_page;
-		l->pages_len++;
-	}
-
-	u8 *target = (u8 *)l->pages[page_idx] + (item_idx * l->item_size);
-	memcpy(target, item_ptr, l->item_size);
-	l->count++;
-}
-
-static void *internal_get(List *l, u64 index) {
-	if (index >= l->count)
-		return NULL;
-	u64 page_idx = index / PAGE_SIZE;
-	u64 item_idx = index % PAGE_SIZE;
-	return (u8 *)l->pages[page_idx] + (item_idx * l->item_size);
-}
-
-static void internal_remove(List *l, u64 index) {
-	if (index >= l->count)
-		return;
-
-	void *victim = internal_get(l, index);
-	void *last = internal_get(l, l->count - 1);
-
-	if (index != l->count - 1) {
-		memcpy(victim, last, l->item_size);
-	}
-	l->count--;
-}
-
-// --- NAMESPACE ---
-
-const ListNamespace list = {
-	.create = internal_create,
-	.push = internal_push,
-	.get = internal_get,
-	.remove = internal_remove,
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <string.h>
+#include "camelot.h"
+// clang-format on
+
+// --- EXTERNAL LINKAGE ---
+extern void list_parallel_for(List *l, ListSpanFn fn, void *ctx, u32 workers);
+extern Result list_parallel_reduce(List *l, void *acc, u64 acc_size, ListFoldFn fold,
+								   ListMergeFn merge, void *ctx, u32 workers);
+extern Result list_parallel_map(List *dst, List *src, ListMapFn map, void *ctx, u32 workers);
+extern Result list_sort(List *l, ListCmpFn cmp, void *ctx, u32 workers);
+extern Result list_radix_sort(List *l, u64 key_offset, u64 key_size);
+extern u64 list_lower_bound(List *l, const void *key, ListCmpFn cmp, void *ctx);
+extern void *list_search(List *l, const void *key, ListCmpFn cmp, void *ctx);
+
+// --- INTERNAL IMPLEMENTATION ---
+
+static List internal_create_paged(Arena *a, u64 item_size, u64 page_bytes) {
+	u64 initial_cap = 16;
+	void **dir = arena.alloc(a, sizeof(void *) * initial_cap);
+	u32 shift = LIST_PAGE_SHIFT_FOR(item_size ? item_size : 1, page_bytes ? page_bytes : 1);
+
+	return (List){
+		.source = a,
+		.pages = dir,
+		.pages_cap = dir ? initial_cap : 0,
+		.pages_len = 0,
+		.item_size = item_size,
+		.count = 0,
+		.page_shift = shift,
+		.page_mask = (1ULL << shift) - 1,
+	};
+}
+
+static List internal_create(Arena *a, u64 item_size) {
+	return internal_create_paged(a, item_size, LIST_PAGE_BYTES);
+}
+
+static bool ensure_directory(List *l, u64 needed) {
+	if (needed <= l->pages_cap)
+		return true;
+
+	u64 new_cap = l->pages_cap ? l->pages_cap : 16;
+	while (new_cap < needed)
+		new_cap *= 2;
+
+	void **new_dir =
+		arena.extend(l->source, l->pages, sizeof(void *) * l->pages_cap, sizeof(void *) * new_cap);
+
+	if (!new_dir)
+		return false; // OOM is recorded on the Arena
+	l->pages = new_dir;
+	l->pages_cap = new_cap;
+	return true;
+}
+
+// Allocates pages until 'pages' of them exist. Pages already in the
+// directory (from reserve) are reused as-is.
+static bool ensure_pages(List *l, u64 pages) {
+	if (pages <= l->pages_len)
+		return true;
+	if (!ensure_directory(l, pages))
+		return false;
+
+	while (l->pages_len < pages) {
+		void *page = arena.alloc_aligned(l->source, l->item_size << l->page_shift, CACHE_LINE);
+		if (!page)
+			return false;
+		l->pages[l->pages_len++] = page;
+	}
+	return true;
+}
+
+static void *internal_push_slot(List *l) {
+	u64 page_idx = l->count >> l->page_shift;
+	u64 item_idx = l->count & l->page_mask;
+
+	if (!ensure_pages(l, page_idx + 1))
+		return NULL;
+
+	l->count++;
+	return (u8 *)l->pages[page_idx] + (item_idx * l->item_size);
+}
+
+static void internal_push(List *l, void *item_ptr) {
+	void *target = internal_push_slot(l);
+	if (target)
+		memcpy(target, item_ptr, l->item_size);
+}
+
+static Result internal_reserve(List *l, u64 n) {
+	return ensure_pages(l, (n + l->page_mask) >> l->page_shift) ? OK : OOM;
+}
+
+static u64 internal_push_n(List *l, const void *src, u64 n) {
+	const u8 *from = src;
+	u64 done = 0;
+
+	// One memcpy per destination page.
+	while (done < n) {
+		u64 page_idx = l->count >> l->page_shift;
+		u64 item_idx = l->count & l->page_mask;
+		if (!ensure_pages(l, page_idx + 1))
+			break;
+
+		u64 span = (l->page_mask + 1) - item_idx;
+		if (span > n - done)
+			span = n - done;
+
+		u8 *target = (u8 *)l->pages[page_idx] + (item_idx * l->item_size);
+		memcpy(target, from + done * l->item_size, span * l->item_size);
+		l->count += span;
+		done += span;
+	}
+	return done;
+}
+
+static u64 internal_extend(List *l, const List *other) {
+	if (other->item_size != l->item_size)
+		return 0;
+
+	// Walks the source pages; geometries may differ, push_n re-splits.
+	// 'total' is fixed up front so list.extend(&l, &l) doubles once.
+	u64 total = other->count;
+	u64 done = 0;
+	for (u64 p = 0; done < total; p++) {
+		u64 span = total - done;
+		if (span > other->page_mask + 1)
+			span = other->page_mask + 1;
+
+		u64 pushed = internal_push_n(l, other->pages[p], span);
+		done += pushed;
+		if (pushed < span)
+			break;
+	}
+	return done;
+}
+
+static void *internal_get(List *l, u64 index) {
+	if (index >= l->count)
+		return NULL;
+	u64 page_idx = index >> l->page_shift;
+	u64 item_idx = index & l->page_mask;
+	return (u8 *)l->pages[page_idx] + (item_idx * l->item_size);
+}
+
+static void internal_remove(List *l, u64 index) {
+	if (index >= l->count)
+		return;
+
+	void *victim = internal_get(l, index);
+	void *last = internal_get(l, l->count - 1);
+
+	if (index != l->count - 1) {
+		memcpy(victim, last, l->item_size);
+	}
+	l->count--;
+}
+
+static bool internal_pop(List *l, void *out) {
+	if (l->count == 0)
+		return false;
+	if (out)
+		memcpy(out, internal_get(l, l->count - 1), l->item_size);
+	l->count--;
+	return true;
+}
+
+// Pages past the new end stay in the directory; push_slot and ensure_pages
+// reuse them before asking the Arena for more.
+static void internal_truncate(List *l, u64 count) {
+	if (count < l->count)
+		l->count = count;
+}
+
+static void internal_clear(List *l) {
+	l->count = 0;
+}
+
+static ListCursor internal_cursor(List *l, u64 start) {
+	return (ListCursor){.list = l, .next = start, .reverse = false};
+}
+
+static ListCursor internal_rcursor(List *l, u64 start) {
+	// 'next' is one past the next item to yield when walking backwards.
+	u64 next = start < l->count ? start + 1 : l->count;
+	return (ListCursor){.list = l, .next = next, .reverse = true};
+}
+
+static bool internal_next(ListCursor *c) {
+	List *l = c->list;
+
+	if (c->reverse) {
+		if (c->next == 0)
+			return false;
+		u64 page_idx = (c->next - 1) >> l->page_shift;
+		c->at = page_idx << l->page_shift;
+		c->len = c->next - c->at;
+		c->ptr = l->pages[page_idx];
+		c->next = c->at;
+		return true;
+	}
+
+	if (c->next >= l->count)
+		return false;
+	u64 page_idx = c->next >> l->page_shift;
+	u64 item_idx = c->next & l->page_mask;
+	c->at = c->next;
+	c->len = (l->page_mask + 1) - item_idx;
+	if (c->len > l->count - c->at)
+		c->len = l->count - c->at;
+	c->ptr = (u8 *)l->pages[page_idx] + (item_idx * l->item_size);
+	c->next += c->len;
+	return true;
+}
+
+// --- NAMESPACE ---
+
+const ListNamespace list = {
+	.create = internal_create,
+	.create_paged = internal_create_paged,
+	.push = internal_push,
+	.push_slot = internal_push_slot,
+	.push_n = internal_push_n,
+	.extend = internal_extend,
+	.reserve = internal_reserve,
+	.get = internal_get,
+	.remove = internal_remove,
+	.pop = internal_pop,
+	.truncate = internal_truncate,
+	.clear = internal_clear,
+	.cursor = internal_cursor,
+	.rcursor = internal_rcursor,
+	.next = internal_next,
+	.parallel_for = list_parallel_for,
+	.parallel_reduce = list_parallel_reduce,
+	.parallel_map = list_parallel_map,
+	.sort = list_sort,
+	.radix_sort = list_radix_sort,
+	.lower_bound = list_lower_bound,
+	.search = list_search,
 };
\ No newline at end of file
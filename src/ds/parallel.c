@@ -0,0 +1,290 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h> // sysconf
+#include "camelot.h"
+// clang-format on
+
+// Work is split into numbered units (list pages, merge pairs). Workers
+// claim the next unit from a shared counter, so uneven per-unit cost
+// balances itself.
+typedef struct {
+	_Atomic u64 next;
+	u64 units;
+	void (*unit)(void *job, u64 i, u32 worker);
+	void *job;
+} Crew;
+
+// --- HELPERS ---
+
+// 'worker' is unique among the threads of one job: 0 is the caller.
+static void crew_work(Crew *c, u32 worker) {
+	for (;;) {
+		u64 i = atomic_fetch_add_explicit(&c->next, 1, memory_order_relaxed);
+		if (i >= c->units)
+			break;
+		c->unit(c->job, i, worker);
+	}
+}
+
+// Page 'p' of 'l' as a span.
+static void *page_span(const List *l, u64 p, u64 *len, u64 *at) {
+	*at = p << l->page_shift;
+	*len = l->count - *at;
+	if (*len > l->page_mask + 1)
+		*len = l->page_mask + 1;
+	return l->pages[p];
+}
+
+static u64 page_count(const List *l) {
+	return (l->count + l->page_mask) >> l->page_shift;
+}
+
+// --- HELPER THREADS ---
+
+// Helpers are started on first use and parked on 'wake' between jobs, so
+// calls in a loop (one per merge pass in list.sort) pay no thread creation.
+// One job runs at a time: 'busy' is held by the thread driving it.
+static struct {
+	pthread_mutex_t lock;
+	pthread_cond_t wake; // A job was posted
+	pthread_cond_t done; // The last helper left the job
+	pthread_mutex_t busy;
+	u32 started;	// Helpers alive (never exit)
+	u32 wanted;		// Helpers the current job admits
+	u32 joined;		// Helpers admitted so far
+	u32 active;		// Helpers still working on the job
+	u64 generation; // Bumped per job
+	Crew *crew;
+} helpers = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.wake = PTHREAD_COND_INITIALIZER,
+	.done = PTHREAD_COND_INITIALIZER,
+	.busy = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static void *helper_main(void *arg) {
+	u64 seen = (u64)(uintptr_t)arg; // Generation current at spawn
+
+	pthread_mutex_lock(&helpers.lock);
+	for (;;) {
+		while (helpers.generation == seen)
+			pthread_cond_wait(&helpers.wake, &helpers.lock);
+		seen = helpers.generation;
+		if (helpers.joined == helpers.wanted)
+			continue; // Job is full or already closed
+
+		u32 worker = ++helpers.joined;
+		helpers.active++;
+		Crew *c = helpers.crew;
+		pthread_mutex_unlock(&helpers.lock);
+
+		crew_work(c, worker);
+
+		pthread_mutex_lock(&helpers.lock);
+		if (--helpers.active == 0)
+			pthread_cond_signal(&helpers.done);
+	}
+	return NULL;
+}
+
+// Tops the pool up to 'count' helpers. Called with 'lock' held.
+static u32 helpers_grow(u32 count) {
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	while (helpers.started < count) {
+		pthread_t t;
+		void *seen = (void *)(uintptr_t)helpers.generation;
+		if (pthread_create(&t, &attr, helper_main, seen) != 0)
+			break;
+		helpers.started++;
+	}
+	pthread_attr_destroy(&attr);
+	return helpers.started < count ? helpers.started : count;
+}
+
+// --- INTERNAL LINKAGE (sort.c) ---
+
+// Threads a job over 'units' may use: 0 means one per online CPU, and
+// never more than LIST_MAX_WORKERS or one per unit.
+u32 parallel_workers(u64 units, u32 workers) {
+	if (workers == 0) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		workers = online > 0 ? (u32)online : 1;
+	}
+	if (workers > LIST_MAX_WORKERS)
+		workers = LIST_MAX_WORKERS;
+	if (workers > units)
+		workers = (u32)units;
+	return workers;
+}
+
+// Runs unit(job, 0..units-1, worker) on up to parallel_workers(units,
+// workers) threads, the calling thread included; 'worker' stays below that
+// count. Helpers that fail to start are simply absent. A call made while
+// another job is running (from a second thread, or nested inside a unit)
+// runs on its caller alone.
+void parallel_run(u64 units, void (*unit)(void *job, u64 i, u32 worker), void *job, u32 workers) {
+	Crew c = {.units = units, .unit = unit, .job = job};
+	atomic_init(&c.next, 0);
+
+	workers = parallel_workers(units, workers);
+	if (workers <= 1 || pthread_mutex_trylock(&helpers.busy) != 0) {
+		crew_work(&c, 0);
+		return;
+	}
+
+	pthread_mutex_lock(&helpers.lock);
+	helpers.wanted = helpers_grow(workers - 1);
+	helpers.joined = 0;
+	helpers.crew = &c;
+	helpers.generation++;
+	pthread_cond_broadcast(&helpers.wake);
+	pthread_mutex_unlock(&helpers.lock);
+
+	crew_work(&c, 0);
+
+	// Close the job to late wakers, then wait for those already inside.
+	pthread_mutex_lock(&helpers.lock);
+	helpers.wanted = helpers.joined;
+	while (helpers.active > 0)
+		pthread_cond_wait(&helpers.done, &helpers.lock);
+	helpers.crew = NULL;
+	pthread_mutex_unlock(&helpers.lock);
+	pthread_mutex_unlock(&helpers.busy);
+}
+
+// --- INTERNAL LINKAGE (list.c) ---
+
+typedef struct {
+	const List *list;
+	ListSpanFn fn;
+	void *ctx;
+} ForJob;
+
+static void for_page(void *job, u64 p, u32 worker) {
+	(void)worker;
+	ForJob *j = job;
+	u64 len, at;
+	void *items = page_span(j->list, p, &len, &at);
+	j->fn(items, len, at, j->ctx);
+}
+
+void list_parallel_for(List *l, ListSpanFn fn, void *ctx, u32 workers) {
+	ForJob job = {.list = l, .fn = fn, .ctx = ctx};
+	parallel_run(page_count(l), for_page, &job, workers);
+}
+
+typedef struct {
+	const List *list;
+	const void *identity;
+	u64 acc_size;
+	u64 stride;
+	u8 *partials;
+	ListFoldFn fold;
+	void *ctx;
+} ReduceJob;
+
+static void reduce_page(void *job, u64 p, u32 worker) {
+	(void)worker;
+	ReduceJob *j = job;
+	u64 len, at;
+	void *items = page_span(j->list, p, &len, &at);
+	void *part = j->partials + p * j->stride;
+	memcpy(part, j->identity, j->acc_size);
+	j->fold(part, items, len, j->ctx);
+}
+
+Result list_parallel_reduce(List *l, void *acc, u64 acc_size, ListFoldFn fold, ListMergeFn merge,
+							void *ctx, u32 workers) {
+	if (l->count == 0)
+		return OK;
+
+	// One partial per page, each on its own cache lines. Merging them in
+	// page order makes the result independent of the worker count.
+	u64 pages = page_count(l);
+	u64 stride = (acc_size + CACHE_LINE - 1) & ~(u64)(CACHE_LINE - 1);
+	ArenaMark tmp = arena.scratch(l->source);
+	u8 *partials = arena.alloc_aligned(tmp.arena, pages * stride, CACHE_LINE);
+	if (!partials) {
+		arena.rewind(tmp);
+		return OOM;
+	}
+
+	ReduceJob job = {
+		.list = l,
+		.identity = acc,
+		.acc_size = acc_size,
+		.stride = stride,
+		.partials = partials,
+		.fold = fold,
+		.ctx = ctx,
+	};
+	parallel_run(pages, reduce_page, &job, workers);
+
+	for (u64 p = 0; p < pages; p++) {
+		merge(acc, partials + p * stride, ctx);
+	}
+	arena.rewind(tmp);
+	return OK;
+}
+
+typedef struct {
+	const List *src;
+	List *dst;
+	u64 base;
+	u64 src_size;
+	ListMapFn map;
+	void *ctx;
+} MapJob;
+
+// Maps one source page, splitting it wherever the destination (whose
+// geometry may differ) crosses a page boundary.
+static void map_page(void *job, u64 p, u32 worker) {
+	(void)worker;
+	MapJob *j = job;
+	List *d = j->dst;
+	u64 len, at;
+	void *items = page_span(j->src, p, &len, &at);
+
+	for (u64 k = 0; k < len;) {
+		u64 i = j->base + at + k;
+		u64 off = i & d->page_mask;
+		u64 n = (d->page_mask + 1) - off;
+		if (n > len - k)
+			n = len - k;
+		u8 *out = (u8 *)d->pages[i >> d->page_shift] + off * d->item_size;
+		j->map(out, (u8 *)items + k * j->src_size, n, j->ctx);
+		k += n;
+	}
+}
+
+Result list_parallel_map(List *dst, List *src, ListMapFn map, void *ctx, u32 workers) {
+	u64 base = dst->count;
+	if (list.reserve(dst, base + src->count) != OK)
+		return OOM;
+
+	MapJob job = {
+		.src = src,
+		.dst = dst,
+		.base = base,
+		.src_size = src->item_size,
+		.map = map,
+		.ctx = ctx,
+	};
+	parallel_run(page_count(src), map_page, &job, workers);
+
+	dst->count = base + src->count;
+	return OK;
+}
@@ -0,0 +1,152 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <stdatomic.h>
+#include <string.h>
+#include "camelot.h"
+// clang-format on
+
+// --- HELPERS ---
+
+static u64 round_pow2(u64 n) {
+	return n <= 2 ? 2 : 1ULL << (64 - __builtin_clzll(n - 1));
+}
+
+static inline _Atomic u64 *cell_seq(Queue *q, u64 pos) {
+	return (_Atomic u64 *)(q->cells + (pos & q->mask) * q->stride);
+}
+
+// --- INTERNAL IMPLEMENTATION (Ring) ---
+
+static Ring ring_create(Arena *a, u64 item_size, u64 capacity) {
+	u64 cap = round_pow2(capacity);
+	u8 *slots = arena.alloc_aligned(a, cap * item_size, CACHE_LINE);
+
+	Ring r = {
+		.slots = slots,
+		.mask = slots ? cap - 1 : 0,
+		.item_size = item_size,
+		.status = slots ? OK : OOM,
+	};
+	atomic_init(&r.head, 0);
+	atomic_init(&r.tail, 0);
+	return r;
+}
+
+static bool ring_push(Ring *r, const void *item) {
+	if (!r->slots)
+		return false;
+
+	u64 tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+	if (tail - r->head_cache > r->mask) {
+		r->head_cache = atomic_load_explicit(&r->head, memory_order_acquire);
+		if (tail - r->head_cache > r->mask)
+			return false;
+	}
+	memcpy(r->slots + (tail & r->mask) * r->item_size, item, r->item_size);
+	atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+	return true;
+}
+
+static bool ring_pop(Ring *r, void *out) {
+	u64 head = atomic_load_explicit(&r->head, memory_order_relaxed);
+	if (head == r->tail_cache) {
+		r->tail_cache = atomic_load_explicit(&r->tail, memory_order_acquire);
+		if (head == r->tail_cache)
+			return false;
+	}
+	memcpy(out, r->slots + (head & r->mask) * r->item_size, r->item_size);
+	atomic_store_explicit(&r->head, head + 1, memory_order_release);
+	return true;
+}
+
+// --- INTERNAL IMPLEMENTATION (Queue) ---
+
+static Queue queue_create(Arena *a, u64 item_size, u64 capacity) {
+	u64 cap = round_pow2(capacity);
+	u64 stride = (sizeof(u64) + item_size + 7) & ~(u64)7;
+	u8 *cells = arena.alloc_aligned(a, cap * stride, CACHE_LINE);
+
+	Queue q = {
+		.cells = cells,
+		.mask = cells ? cap - 1 : 0,
+		.item_size = item_size,
+		.stride = stride,
+		.status = cells ? OK : OOM,
+	};
+	atomic_init(&q.head, 0);
+	atomic_init(&q.tail, 0);
+
+	// Cell i is first writable at position i.
+	for (u64 i = 0; cells && i < cap; i++) {
+		atomic_init(cell_seq(&q, i), i);
+	}
+	return q;
+}
+
+static bool queue_push(Queue *q, const void *item) {
+	if (!q->cells)
+		return false;
+
+	u64 pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+	for (;;) {
+		_Atomic u64 *seq = cell_seq(q, pos);
+		i64 dif = (i64)(atomic_load_explicit(seq, memory_order_acquire) - pos);
+		if (dif == 0) {
+			if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1,
+													  memory_order_relaxed, memory_order_relaxed)) {
+				memcpy((u8 *)seq + sizeof(u64), item, q->item_size);
+				atomic_store_explicit(seq, pos + 1, memory_order_release);
+				return true;
+			}
+		} else if (dif < 0) {
+			return false; // Full: the cell still holds an item from one lap ago
+		} else {
+			pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+		}
+	}
+}
+
+static bool queue_pop(Queue *q, void *out) {
+	if (!q->cells)
+		return false;
+
+	u64 pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+	for (;;) {
+		_Atomic u64 *seq = cell_seq(q, pos);
+		i64 dif = (i64)(atomic_load_explicit(seq, memory_order_acquire) - (pos + 1));
+		if (dif == 0) {
+			if (atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + 1,
+													  memory_order_relaxed, memory_order_relaxed)) {
+				memcpy(out, (u8 *)seq + sizeof(u64), q->item_size);
+				atomic_store_explicit(seq, pos + q->mask + 1, memory_order_release);
+				return true;
+			}
+		} else if (dif < 0) {
+			return false; // Empty: the cell has not been written this lap
+		} else {
+			pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+		}
+	}
+}
+
+// --- NAMESPACE ---
+
+const RingNamespace ring = {
+	.create = ring_create,
+	.push = ring_push,
+	.pop = ring_pop,
+};
+
+const QueueNamespace queue = {
+	.create = queue_create,
+	.push = queue_push,
+	.pop = queue_pop,
+};
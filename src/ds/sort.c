@@ -0,0 +1,466 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <string.h>
+#include "camelot.h"
+// clang-format on
+
+#define SORT_INSERTION 16 // Runs this short are insertion sorted
+#define SORT_SPARES 2	  // Spare pages per merging worker (see merge_pair)
+#define SORT_NONE (~0ULL)
+
+// --- EXTERNAL LINKAGE ---
+extern u32 parallel_workers(u64 units, u32 workers);
+extern void parallel_run(u64 units, void (*unit)(void *job, u64 i, u32 worker), void *job,
+						 u32 workers);
+
+// --- HELPERS ---
+
+static inline void *item_at(const List *l, u64 i) {
+	return (u8 *)l->pages[i >> l->page_shift] + (i & l->page_mask) * l->item_size;
+}
+
+static void swap_bytes(u8 *a, u8 *b, u64 size) {
+	u8 tmp[64];
+	while (size) {
+		u64 n = size < sizeof(tmp) ? size : sizeof(tmp);
+		memcpy(tmp, a, n);
+		memcpy(a, b, n);
+		memcpy(b, tmp, n);
+		a += n, b += n, size -= n;
+	}
+}
+
+static void insertion_sort(u8 *base, u64 n, u64 size, ListCmpFn cmp, void *ctx) {
+	for (u64 i = 1; i < n; i++) {
+		for (u64 j = i; j > 0 && cmp(base + j * size, base + (j - 1) * size, ctx) < 0; j--) {
+			swap_bytes(base + j * size, base + (j - 1) * size, size);
+		}
+	}
+}
+
+static void sift_down(u8 *base, u64 root, u64 n, u64 size, ListCmpFn cmp, void *ctx) {
+	for (u64 child; (child = 2 * root + 1) < n; root = child) {
+		if (child + 1 < n && cmp(base + child * size, base + (child + 1) * size, ctx) < 0)
+			child++;
+		if (cmp(base + root * size, base + child * size, ctx) >= 0)
+			return;
+		swap_bytes(base + root * size, base + child * size, size);
+	}
+}
+
+static void heap_sort(u8 *base, u64 n, u64 size, ListCmpFn cmp, void *ctx) {
+	for (u64 i = n / 2; i-- > 0;) {
+		sift_down(base, i, n, size, cmp, ctx);
+	}
+	for (u64 end = n; end-- > 1;) {
+		swap_bytes(base, base + end * size, size);
+		sift_down(base, 0, end, size, cmp, ctx);
+	}
+}
+
+// Introsort over one contiguous run: median-of-three quicksort that falls
+// back to heapsort when the recursion budget runs out.
+static void intro_sort(u8 *base, u64 n, u64 size, ListCmpFn cmp, void *ctx, u32 depth) {
+	while (n > SORT_INSERTION) {
+		if (depth-- == 0) {
+			heap_sort(base, n, size, cmp, ctx);
+			return;
+		}
+
+		// Order first/middle/last, then park the median at index 1.
+		u8 *lo = base, *mid = base + (n / 2) * size, *hi = base + (n - 1) * size;
+		if (cmp(mid, lo, ctx) < 0)
+			swap_bytes(mid, lo, size);
+		if (cmp(hi, mid, ctx) < 0) {
+			swap_bytes(hi, mid, size);
+			if (cmp(mid, lo, ctx) < 0)
+				swap_bytes(mid, lo, size);
+		}
+		u8 *pivot = base + size;
+		swap_bytes(mid, pivot, size);
+
+		// Hoare partition of [2, n-2] around the pivot.
+		u64 i = 1, j = n - 1;
+		for (;;) {
+			while (cmp(base + (++i) * size, pivot, ctx) < 0) {
+			}
+			while (cmp(pivot, base + (--j) * size, ctx) < 0) {
+			}
+			if (i >= j)
+				break;
+			swap_bytes(base + i * size, base + j * size, size);
+		}
+		swap_bytes(pivot, base + j * size, size);
+
+		// Recurse into the smaller side, loop on the larger.
+		if (j < n - j - 1) {
+			intro_sort(base, j, size, cmp, ctx, depth);
+			base += (j + 1) * size;
+			n -= j + 1;
+		} else {
+			intro_sort(base + (j + 1) * size, n - j - 1, size, cmp, ctx, depth);
+			n = j;
+		}
+	}
+	insertion_sort(base, n, size, cmp, ctx);
+}
+
+static u32 depth_budget(u64 n) {
+	return 2 * (64 - __builtin_clzll(n | 1));
+}
+
+static u64 load_key(const u8 *p, u64 size) {
+	switch (size) {
+	case 1:
+		return *p;
+	case 2: {
+		u16 k;
+		memcpy(&k, p, 2);
+		return k;
+	}
+	case 4: {
+		u32 k;
+		memcpy(&k, p, 4);
+		return k;
+	}
+	default: {
+		u64 k;
+		memcpy(&k, p, 8);
+		return k;
+	}
+	}
+}
+
+static u64 page_items(const List *l, u64 p) {
+	u64 n = l->count - (p << l->page_shift);
+	return n > l->page_mask ? l->page_mask + 1 : n;
+}
+
+// --- PAGE MERGE ---
+
+// Merges move items between pages, never through a flat copy. Every page
+// has an id: ids below the page count are the list's own pages, the rest
+// are scratch spares. A level reads runs through one directory of ids and
+// builds the next; an input page is recycled as output once drained.
+
+// Free page ids of one worker, on their own cache line.
+typedef struct {
+	_Alignas(CACHE_LINE) u64 ids[SORT_SPARES + 2];
+	u64 len;
+} Spares;
+
+typedef struct {
+	List *list;
+	ListCmpFn cmp;
+	void *ctx;
+	u8 **phys;		// Page id -> page
+	u64 *from;		// Directory of the level being merged
+	u64 *to;		// Directory of the next level
+	Spares *spares; // One per worker
+	u64 width;		// Run length in items (a whole number of pages)
+} SortJob;
+
+// A sorted run consumed item by item; 'stop' ends the current page.
+typedef struct {
+	u64 at;
+	u64 end;
+	u8 *ptr;
+	u8 *stop;
+} Run;
+
+static void run_load(const SortJob *j, Run *r) {
+	const List *l = j->list;
+	u64 page = r->at >> l->page_shift;
+	u64 last = (r->end - 1) >> l->page_shift;
+	u64 span = page < last ? l->page_mask + 1 : ((r->end - 1) & l->page_mask) + 1;
+	r->ptr = j->phys[j->from[page]] + (r->at & l->page_mask) * l->item_size;
+	r->stop = j->phys[j->from[page]] + span * l->item_size;
+}
+
+// Moves past 'n' items of the current page; a drained page becomes spare.
+static void run_skip(const SortJob *j, Run *r, Spares *s, u64 n) {
+	r->at += n;
+	r->ptr += n * j->list->item_size;
+	if (r->ptr == r->stop) {
+		s->ids[s->len++] = j->from[(r->at - 1) >> j->list->page_shift];
+		if (r->at < r->end)
+			run_load(j, r);
+	}
+}
+
+// Room left on the output page; a full page is replaced from the spares.
+static u64 out_room(const SortJob *j, Spares *s, u64 at, u8 **out) {
+	const List *l = j->list;
+	if ((at & l->page_mask) == 0) {
+		u64 id = s->ids[--s->len];
+		j->to[at >> l->page_shift] = id;
+		*out = j->phys[id];
+	}
+	return (l->page_mask + 1) - (at & l->page_mask);
+}
+
+static void sort_page(void *job, u64 p, u32 worker) {
+	(void)worker;
+	SortJob *j = job;
+	List *l = j->list;
+	u64 n = page_items(l, p);
+	intro_sort(l->pages[p], n, l->item_size, j->cmp, j->ctx, depth_budget(n));
+}
+
+// Stable merge of runs [lo, mid) and [mid, hi). After writing t output
+// pages at least t - 1 input pages are drained, so two spares per worker
+// always cover the next output page; the worker ends with as many spares
+// as it started with.
+static void merge_pair(void *job, u64 i, u32 worker) {
+	SortJob *j = job;
+	const List *l = j->list;
+	u64 n = l->count, size = l->item_size;
+	u64 lo = i * 2 * j->width;
+	u64 mid = lo + j->width < n ? lo + j->width : n;
+	u64 hi = lo + 2 * j->width < n ? lo + 2 * j->width : n;
+
+	if (mid == hi) {
+		// Lone run: its pages carry over unchanged.
+		for (u64 p = lo >> l->page_shift; p <= (hi - 1) >> l->page_shift; p++) {
+			j->to[p] = j->from[p];
+		}
+		return;
+	}
+
+	Spares *s = &j->spares[worker];
+	Run a = {.at = lo, .end = mid}, b = {.at = mid, .end = hi};
+	run_load(j, &a);
+	run_load(j, &b);
+
+	u64 at = lo;
+	u8 *out = NULL;
+	while (a.at < a.end && b.at < b.end) {
+		u64 room = out_room(j, s, at, &out);
+		for (; room && a.at < a.end && b.at < b.end; room--) {
+			Run *take = j->cmp(b.ptr, a.ptr, j->ctx) < 0 ? &b : &a;
+			memcpy(out, take->ptr, size);
+			out += size;
+			at++;
+			run_skip(j, take, s, 1);
+		}
+	}
+
+	// Drain the rest in page-sized spans.
+	Run *rest = a.at < a.end ? &a : &b;
+	while (rest->at < rest->end) {
+		u64 room = out_room(j, s, at, &out);
+		u64 span = (u64)(rest->stop - rest->ptr) / size;
+		if (span > room)
+			span = room;
+		memcpy(out, rest->ptr, span * size);
+		out += span * size;
+		at += span;
+		run_skip(j, rest, s, span);
+	}
+}
+
+// Copies logical page p back into the list's own page p for every p, so
+// pages keep their identity and no scratch page stays in the list. A page
+// still holding another slot's items is first moved to a vacant page.
+static void restore_pages(SortJob *j, u64 pages, u64 ids, u64 *where, u64 *vacant) {
+	List *l = j->list;
+	u64 *dir = j->from;
+	u64 top = 0;
+
+	for (u64 id = 0; id < ids; id++) {
+		where[id] = SORT_NONE;
+	}
+	for (u64 p = 0; p < pages; p++) {
+		where[dir[p]] = p;
+	}
+	for (u64 id = 0; id < ids; id++) {
+		if (where[id] == SORT_NONE)
+			vacant[top++] = id;
+	}
+
+	for (u64 p = 0; p < pages; p++) {
+		if (dir[p] == p)
+			continue;
+
+		u64 q = where[p];
+		if (q != SORT_NONE) {
+			u64 g;
+			do {
+				g = vacant[--top]; // Stale entries were reused since
+			} while (where[g] != SORT_NONE);
+			memcpy(j->phys[g], j->phys[p], page_items(l, q) * l->item_size);
+			dir[q] = g;
+			where[g] = q;
+		}
+
+		u64 f = dir[p];
+		memcpy(j->phys[p], j->phys[f], page_items(l, p) * l->item_size);
+		dir[p] = p;
+		where[p] = p;
+		where[f] = SORT_NONE;
+		vacant[top++] = f;
+	}
+}
+
+// --- INTERNAL LINKAGE (list.c) ---
+
+Result list_sort(List *l, ListCmpFn cmp, void *ctx, u32 workers) {
+	if (l->count < 2)
+		return OK;
+
+	// Pages are independent contiguous runs: sort each in place.
+	u64 pages = (l->count + l->page_mask) >> l->page_shift;
+	SortJob job = {.list = l, .cmp = cmp, .ctx = ctx};
+	if (pages == 1) {
+		sort_page(&job, 0, 0);
+		return OK;
+	}
+
+	u32 crew = parallel_workers(pages / 2, workers);
+	u64 extra = (u64)crew * SORT_SPARES;
+	u64 ids = pages + extra;
+	u64 page_bytes = (l->page_mask + 1) * l->item_size;
+
+	ArenaMark tmp = arena.scratch(l->source);
+	job.phys = arena.alloc(tmp.arena, ids * sizeof(u8 *));
+	job.from = arena.alloc(tmp.arena, pages * sizeof(u64));
+	job.to = arena.alloc(tmp.arena, pages * sizeof(u64));
+	job.spares = arena.alloc_aligned(tmp.arena, crew * sizeof(Spares), CACHE_LINE);
+	u8 *spare = arena.alloc_aligned(tmp.arena, extra * page_bytes, CACHE_LINE);
+	u64 *where = arena.alloc(tmp.arena, ids * sizeof(u64));
+	u64 *vacant = arena.alloc(tmp.arena, ids * sizeof(u64));
+	if (!job.phys || !job.from || !job.to || !job.spares || !spare || !where || !vacant) {
+		arena.rewind(tmp);
+		return OOM;
+	}
+
+	for (u64 p = 0; p < pages; p++) {
+		job.phys[p] = l->pages[p];
+		job.from[p] = p;
+	}
+	for (u32 w = 0; w < crew; w++) {
+		job.spares[w].len = SORT_SPARES;
+		for (u32 k = 0; k < SORT_SPARES; k++) {
+			u64 id = pages + w * SORT_SPARES + k;
+			job.phys[id] = spare + (id - pages) * page_bytes;
+			job.spares[w].ids[k] = id;
+		}
+	}
+
+	parallel_run(pages, sort_page, &job, workers);
+
+	// Bottom-up: runs of one page, then two, four, ...
+	for (u64 width = l->page_mask + 1; width < l->count; width *= 2) {
+		job.width = width;
+		u64 pairs = (l->count + 2 * width - 1) / (2 * width);
+		parallel_run(pairs, merge_pair, &job, crew);
+		u64 *t = job.from;
+		job.from = job.to, job.to = t;
+	}
+
+	restore_pages(&job, pages, ids, where, vacant);
+	arena.rewind(tmp);
+	return OK;
+}
+
+// Stable LSD radix sort. Passes alternate between the list's pages and
+// one flat buffer, so scratch holds a single copy of the list.
+Result list_radix_sort(List *l, u64 key_offset, u64 key_size) {
+	if ((key_size != 1 && key_size != 2 && key_size != 4 && key_size != 8) ||
+		key_offset + key_size > l->item_size)
+		return INVALID_KEY;
+	if (l->count < 2)
+		return OK;
+
+	u64 n = l->count, size = l->item_size;
+	u64 pages = (n + l->page_mask) >> l->page_shift;
+	ArenaMark tmp = arena.scratch(l->source);
+	u8 *flat = arena.alloc_aligned(tmp.arena, n * size, CACHE_LINE);
+	u64 *counts = arena.alloc(tmp.arena, key_size * 256 * sizeof(u64));
+	if (!flat || !counts) {
+		arena.rewind(tmp);
+		return OOM;
+	}
+	memset(counts, 0, key_size * 256 * sizeof(u64));
+
+	// All digit histograms in a single read pass over the pages.
+	for (u64 p = 0; p < pages; p++) {
+		const u8 *item = l->pages[p];
+		for (u64 k = page_items(l, p); k > 0; k--, item += size) {
+			u64 key = load_key(item + key_offset, key_size);
+			for (u64 d = 0; d < key_size; d++) {
+				counts[d * 256 + ((key >> (8 * d)) & 0xff)]++;
+			}
+		}
+	}
+
+	// Stable passes; a digit shared by every key is skipped.
+	bool in_pages = true;
+	for (u64 d = 0; d < key_size; d++) {
+		u64 *c = counts + d * 256;
+		u64 sum = 0;
+		bool trivial = false;
+		for (u32 v = 0; v < 256; v++) {
+			u64 cnt = c[v];
+			trivial |= cnt == n;
+			c[v] = sum;
+			sum += cnt;
+		}
+		if (trivial)
+			continue;
+
+		if (in_pages) {
+			for (u64 p = 0; p < pages; p++) {
+				const u8 *item = l->pages[p];
+				for (u64 k = page_items(l, p); k > 0; k--, item += size) {
+					u64 key = load_key(item + key_offset, key_size);
+					memcpy(flat + c[(key >> (8 * d)) & 0xff]++ * size, item, size);
+				}
+			}
+		} else {
+			for (u64 i = 0; i < n; i++) {
+				const u8 *item = flat + i * size;
+				u64 key = load_key(item + key_offset, key_size);
+				memcpy(item_at(l, c[(key >> (8 * d)) & 0xff]++), item, size);
+			}
+		}
+		in_pages = !in_pages;
+	}
+
+	// An odd number of passes leaves the result in the flat buffer.
+	if (!in_pages) {
+		for (u64 p = 0; p < pages; p++) {
+			u64 at = p << l->page_shift;
+			memcpy(l->pages[p], flat + at * size, page_items(l, p) * size);
+		}
+	}
+	arena.rewind(tmp);
+	return OK;
+}
+
+u64 list_lower_bound(List *l, const void *key, ListCmpFn cmp, void *ctx) {
+	u64 lo = 0, hi = l->count;
+	while (lo < hi) {
+		u64 mid = lo + (hi - lo) / 2;
+		if (cmp(item_at(l, mid), key, ctx) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+void *list_search(List *l, const void *key, ListCmpFn cmp, void *ctx) {
+	u64 i = list_lower_bound(l, key, cmp, ctx);
+	if (i < l->count && cmp(item_at(l, i), key, ctx) == 0)
+		return item_at(l, i);
+	return NULL;
+}
@@ -1,126 +1,180 @@
-/*
- * This Source Code Form is subject to the terms of the Mozilla Public
- * License, v. 2.0. If a copy of the MPL was not distributed with this
- * file, You can obtain one at http://mozilla.org/MPL/2.0/.
- *
- * Governed by the Avant Systems Canon (ASC-1.1).
- * Compliance is mandatory for all contributions.
- */
-
-// clang-format off
-#include <string.h>
-#include "camelot.h"
-// clang-format on
-
-// --- CONSTANTS ---
-#define FNV_OFFSET_BASIS 0xcbf29ce484222325
-#define FNV_PRIME 0x100000001b3
-
-// --- HELPERS ---
-
-static u64 hash_str(String s) {
-	u64 hash = FNV_OFFSET_BASIS;
-	for (u64 i = 0; i < s.len; i++) {
-		hash ^= s.ptr[i];
-		hash *= FNV_PRIME;
-	}
-	return hash;
-}
-
-// --- INTERNAL IMPLEMENTATION ---
-
-static Table internal_create(Arena *a, u64 cap) {
-	if (cap < 16)
-		cap = 16;
-
-	Entry *entries = arena.alloc(a, sizeof(Entry) * cap);
-
-	for (u64 i = 0; i < cap; i++)
-		entries[i].alive = false;
-
-	return (Table){
-		.source = a,
-		.entries = entries,
-		.cap = cap,
-		.count = 0,
-	};
-}
-
-static void internal_put(Table *t, String key, void *value);
-
-static void resize(Table *t) {
-	u64 new_cap = t->cap * 2;
-	Entry *old_entries = t->entries;
-	u64 old_cap = t->cap;
-
-	t->entries = arena.alloc(t->source, sizeof(Entry) * new_cap);
-	t->cap = new_cap;
-	t->count = 0;
-
-	for (u64 i = 0; i < new_cap; i++)
-		t->entries[i].alive = false;
-
-	for (u64 i = 0; i < old_cap; i++) {
-		if (old_entries[i].alive) {
-			internal_put(t, old_entries[i].key, old_entries[i].value);
-		}
-	}
-}
-
-static void internal_put(Table *t, String key, void *value) {
-	if (t->count * 4 >= t->cap * 3) {
-		resize(t);
-	}
-
-	u64 h = hash_str(key);
-	u64 idx = h % t->cap;
-
-	while (true) {
-		Entry *e = &t->entries[idx];
-
-		if (!e->alive) {
-			e->key = key;
-			e->value = value;
-			e->alive = true;
-			t->count++;
-			return;
-		}
-
-		if (string.equal(e->key, key)) {
-			e->value = value;
-			return;
-		}
-
-		idx = (idx + 1) % t->cap;
-	}
-}
-
-static void *internal_get(Table *t, String key) {
-	if (t->count == 0)
-		return NULL;
-
-	u64 h = hash_str(key);
-	u64 idx = h % t->cap;
-	u64 start_idx = idx;
-
-	while (true) {
-		Entry *e = &t->entries[idx];
-
-		if (!e->alive)
-			return NULL;
-		if (string.equal(e->key, key))
-			return e->value;
-
-		idx = (idx + 1) % t->cap;
-		if (idx == start_idx)
-			return NULL;
-	}
-}
-
-// --- NAMESPACE ---
-
-const TableNamespace table = {
-	.create = internal_create,
-	.put = internal_put,
-	.get = internal_get,
-};
\ No newline at end of file
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "camelot.h"
+// clang-format on
+
+// --- CONSTANTS ---
+#define CTRL_EMPTY 0x80
+
+// --- HELPERS ---
+
+// Bit i of the result is set when control byte i of the group equals 'b'.
+static inline u32 group_match(const u8 *group, u8 b) {
+#ifdef __SSE2__
+	__m128i g = _mm_loadu_si128((const __m128i *)group);
+	return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)b)));
+#else
+	u32 mask = 0;
+	for (u32 i = 0; i < TABLE_GROUP; i++) {
+		mask |= (u32)(group[i] == b) << i;
+	}
+	return mask;
+#endif
+}
+
+static inline void set_ctrl(Table *t, u64 i, u8 b) {
+	t->ctrl[i] = b;
+	if (i < TABLE_GROUP)
+		t->ctrl[t->cap + i] = b; // Mirror for wrap-free group loads
+}
+
+static inline u64 block_size(u64 cap) {
+	return sizeof(Entry) * cap + cap + TABLE_GROUP;
+}
+
+static void reset_ctrl(Table *t) {
+	t->ctrl = (u8 *)(t->entries + t->cap);
+	memset(t->ctrl, CTRL_EMPTY, t->cap + TABLE_GROUP);
+}
+
+// Walks the probe sequence for 'key'. Returns its slot if present;
+// otherwise returns cap and sets '*empty' to the first free slot (or cap
+// if the table is completely full). Stored hashes are compared before
+// keys, so tag collisions rarely reach string.equal.
+static u64 find(Table *t, String key, u64 h, u64 *empty) {
+	u8 tag = h & 0x7f;
+	u64 mask = t->cap - 1;
+	u64 pos = (h >> 7) & mask;
+
+	// Triangular steps of whole groups visit every group once.
+	for (u64 stride = TABLE_GROUP; stride <= t->cap + TABLE_GROUP; stride += TABLE_GROUP) {
+		const u8 *group = t->ctrl + pos;
+		for (u32 m = group_match(group, tag); m; m &= m - 1) {
+			u64 i = (pos + __builtin_ctz(m)) & mask;
+			if (t->entries[i].hash == h && string.equal(t->entries[i].key, key))
+				return i;
+		}
+		u32 vacant = group_match(group, CTRL_EMPTY);
+		if (vacant) {
+			*empty = (pos + __builtin_ctz(vacant)) & mask;
+			return t->cap;
+		}
+		pos = (pos + stride) & mask;
+	}
+	*empty = t->cap;
+	return t->cap;
+}
+
+// --- INTERNAL IMPLEMENTATION ---
+
+static Table internal_create(Arena *a, u64 cap) {
+	if (cap < 16)
+		cap = 16;
+	cap = 1ULL << (64 - __builtin_clzll(cap - 1));
+
+	Table t = {.source = a, .cap = cap, .count = 0, .seed = hash.seed()};
+	t.entries = arena.alloc_aligned(a, block_size(cap), CACHE_LINE);
+	if (t.entries)
+		reset_ctrl(&t);
+	return t;
+}
+
+// Inserts an entry known to be absent (resize), reusing its stored hash.
+static void place(Table *t, const Entry *e) {
+	u64 empty;
+	u64 mask = t->cap - 1;
+	u64 pos = (e->hash >> 7) & mask;
+	for (u64 stride = TABLE_GROUP;; stride += TABLE_GROUP) {
+		u32 vacant = group_match(t->ctrl + pos, CTRL_EMPTY);
+		if (vacant) {
+			empty = (pos + __builtin_ctz(vacant)) & mask;
+			break;
+		}
+		pos = (pos + stride) & mask;
+	}
+	t->entries[empty] = *e;
+	set_ctrl(t, empty, e->hash & 0x7f);
+	t->count++;
+}
+
+static void resize(Table *t) {
+	u64 new_cap = t->cap * 2;
+	u64 old_cap = t->cap;
+
+	// Reinsert from a scratch copy: the block may grow in place (old slots
+	// get reset) or move on a heap view (old block is recycled). Stored
+	// hashes mean no key is hashed or compared again.
+	Savepoint tmp = arena.scratch(t->source);
+	Entry *old_entries = arena.alloc(tmp.arena, block_size(old_cap));
+	if (!old_entries)
+		return;
+	memcpy(old_entries, t->entries, block_size(old_cap));
+	const u8 *old_ctrl = (const u8 *)(old_entries + old_cap);
+
+	Entry *grown = arena.extend(t->source, t->entries, block_size(old_cap), block_size(new_cap));
+	if (!grown)
+		return;
+
+	t->entries = grown;
+	t->cap = new_cap;
+	t->count = 0;
+	reset_ctrl(t);
+
+	for (u64 i = 0; i < old_cap; i++) {
+		if (old_ctrl[i] != CTRL_EMPTY) {
+			place(t, &old_entries[i]);
+		}
+	}
+}
+
+static void internal_put(Table *t, String key, void *value) {
+	if (!t->entries)
+		return;
+	if ((t->count + 1) * 8 > t->cap * 7) {
+		resize(t);
+	}
+
+	u64 h = hash.str(key, t->seed);
+	u64 empty;
+	u64 i = find(t, key, h, &empty);
+
+	if (i != t->cap) {
+		t->entries[i].value = value;
+		return;
+	}
+	if (empty == t->cap)
+		return; // Full and unable to grow; OOM is recorded on the Arena
+
+	t->entries[empty] = (Entry){.key = key, .value = value, .hash = h};
+	set_ctrl(t, empty, h & 0x7f);
+	t->count++;
+}
+
+static void *internal_get(Table *t, String key) {
+	if (t->count == 0)
+		return NULL;
+
+	u64 empty;
+	u64 i = find(t, key, hash.str(key, t->seed), &empty);
+	return i != t->cap ? t->entries[i].value : NULL;
+}
+
+// --- NAMESPACE ---
+
+const TableNamespace table = {
+	.create = internal_create,
+	.put = internal_put,
+	.get = internal_get,
+};
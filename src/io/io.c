@@ -12,15 +12,148 @@
 #endif
 
 // clang-format off
-#include <stdarg.h> // va_list, va_start, va_end
-#include <stdio.h>  // snprintf
-#include <string.h> // strlen
-#include <unistd.h> // write, read
+#include <errno.h>   // errno, EINTR
+#include <pthread.h> // pthread_once, pthread_key_create
+#include <stdarg.h>  // va_list, va_start, va_end
+#include <stdio.h>   // snprintf
+#include <string.h>  // strlen, memcpy, memmove, memchr
+#include <unistd.h>  // write, read, isatty
 #include "camelot.h"
 // clang-format on
 
 #define IO_DEFAULT_SCAN_CAP 4096
 
+// --- OUTPUT BUFFER ---
+
+#define IO_OUT_CAP 4096
+
+// Per-thread staging area for stdout. Calls append here and reach the
+// descriptor in one write per flush instead of one write per character.
+typedef struct {
+	u8 buf[IO_OUT_CAP];
+	u64 len;
+	Flush mode;
+	bool ready;
+	bool newline; // A newline was appended since the last flush
+} OutBuffer;
+
+static _Thread_local OutBuffer out;
+static pthread_key_t out_key;
+static pthread_once_t out_once = PTHREAD_ONCE_INIT;
+
+static void write_all(const u8 *src, u64 n) {
+	while (n > 0) {
+		ssize_t w = write(1, src, n);
+		if (w < 0 && errno == EINTR)
+			continue;
+		if (w <= 0)
+			return; // stdout closed: drop silently
+		src += w;
+		n -= (u64)w;
+	}
+}
+
+void flush(void) {
+	if (out.len > 0)
+		write_all(out.buf, out.len);
+	out.len = 0;
+	out.newline = false;
+}
+
+static void out_destroy(void *unused) {
+	(void)unused;
+	flush();
+}
+
+static void out_key_init(void) {
+	pthread_key_create(&out_key, out_destroy);
+}
+
+static void out_init(void) {
+	if (out.ready)
+		return;
+	out.mode = isatty(1) ? FLUSH_LINE : FLUSH_FULL;
+	out.ready = true;
+	// Registers the thread-exit hook so worker output is not lost.
+	pthread_once(&out_once, out_key_init);
+	pthread_setspecific(out_key, &out);
+}
+
+void policy(Flush mode) {
+	out_init();
+	flush();
+	out.mode = mode;
+}
+
+static void emit(const void *src, u64 n) {
+	if (n == 0)
+		return;
+
+	if (n > IO_OUT_CAP - out.len) {
+		flush();
+		// Oversized payloads bypass the buffer entirely.
+		if (n >= IO_OUT_CAP) {
+			write_all(src, n);
+			return;
+		}
+	}
+
+	memcpy(out.buf + out.len, src, n);
+	out.len += n;
+	if (!out.newline && memchr(src, '\n', n))
+		out.newline = true;
+}
+
+// Applies the flush policy once per public call.
+static void commit(void) {
+	if (out.mode == FLUSH_NONE || (out.mode == FLUSH_LINE && out.newline))
+		flush();
+}
+
+// Threads flush through 'out_key'; the main thread exits without it.
+__attribute__((destructor)) static void flush_at_exit(void) {
+	flush();
+}
+
+// --- INPUT BUFFER ---
+
+#define IO_IN_CAP 65536
+
+// Read-ahead window over stdin. Bytes in [head, tail) are buffered but not
+// yet consumed; a partial line is carried to the front on the next refill.
+typedef struct {
+	u8 buf[IO_IN_CAP];
+	u64 head;
+	u64 tail;
+} InBuffer;
+
+static InBuffer in;
+
+// Compacts the unconsumed bytes and reads more. Returns bytes added (0 on
+// EOF, error, or when the window is already full).
+static u64 refill(void) {
+	if (in.head > 0) {
+		memmove(in.buf, in.buf + in.head, in.tail - in.head);
+		in.tail -= in.head;
+		in.head = 0;
+	}
+	if (in.tail == IO_IN_CAP)
+		return 0;
+
+	// Prompts written with io.print must be visible before we block.
+	flush();
+
+	ssize_t n;
+	do {
+		n = read(0, in.buf + in.tail, IO_IN_CAP - in.tail);
+	} while (n < 0 && errno == EINTR);
+
+	if (n <= 0)
+		return 0;
+	in.tail += (u64)n;
+	return (u64)n;
+}
+
 // --- SCAN ---
 
 String scan(Arena *a, u64 cap) {
@@ -34,69 +167,109 @@ String scan(Arena *a, u64 cap) {
 	}
 
 	u64 count = 0;
-	char c;
 
 	while (count < cap - 1) {
-		ssize_t n = read(0, &c, 1);
-		if (n <= 0) {
+		if (in.head == in.tail && refill() == 0) {
 			break;
 		}
-		if (c == '\n') {
-			break;
-		}
-		if (c == '\r') {
-			continue; // Ignore CR
+
+		u8 *start = in.buf + in.head;
+		u8 *nl = memchr(start, '\n', in.tail - in.head);
+		u64 span = nl ? (u64)(nl - start) : in.tail - in.head;
+
+		u64 i = 0;
+		for (; i < span && count < cap - 1; i++) {
+			if (start[i] != '\r') { // Ignore CR
+				buf[count++] = start[i];
+			}
 		}
+		in.head += i;
 
-		buf[count++] = c;
+		if (nl && i == span) {
+			in.head++; // Consume the newline
+			break;
+		}
 	}
 
 	buf[count] = '\0';
 	return (String){.ptr = buf, .len = count};
 }
 
+bool lines(String *line) {
+	while (true) {
+		u8 *start = in.buf + in.head;
+		u64 avail = in.tail - in.head;
+		u8 *nl = memchr(start, '\n', avail);
+
+		if (nl) {
+			u64 len = (u64)(nl - start);
+			in.head += len + 1;
+			if (len > 0 && start[len - 1] == '\r')
+				len--;
+			*line = (String){.ptr = start, .len = len};
+			return true;
+		}
+
+		if (refill() > 0)
+			continue;
+
+		// EOF (or a line longer than the window): yield what is left. No LF
+		// follows, so a trailing CR is data and stays in the view.
+		start = in.buf + in.head;
+		avail = in.tail - in.head;
+		if (avail == 0) {
+			*line = (String){0};
+			return false;
+		}
+		in.head = in.tail;
+		*line = (String){.ptr = start, .len = avail};
+		return true;
+	}
+}
+
 // --- PRINT ---
 
 void put(String s) {
-	write(1, s.ptr, s.len);
+	out_init();
+	emit(s.ptr, s.len);
+	commit();
 }
 
 static void put_i64(long long n) {
-	if (n == 0) {
-		write(1, "0", 1);
-		return;
-	}
-	if (n < 0) {
-		write(1, "-", 1);
-		n = -n;
-	}
-
 	char buf[24];
-	int i = 0;
-	while (n > 0) {
-		buf[i++] = (n % 10) + '0';
-		n /= 10;
-	}
-	while (i > 0) {
-		write(1, &buf[--i], 1);
-	}
+	int i = sizeof(buf);
+	unsigned long long u = n < 0 ? 0ULL - (unsigned long long)n : (unsigned long long)n;
+
+	do {
+		buf[--i] = (char)('0' + (u % 10));
+		u /= 10;
+	} while (u > 0);
+
+	if (n < 0)
+		buf[--i] = '-';
+	emit(&buf[i], sizeof(buf) - i);
 }
 
 static void put_f64(double n) {
 	char buf[64];
 	int len = snprintf(buf, sizeof(buf), "%.16g", n);
-	write(1, buf, len);
+	emit(buf, len);
 }
 
 void print(const char *fmt, ...) {
 	va_list args;
 	va_start(args, fmt);
+	out_init();
 
-	for (const char *p = fmt; *p != '\0'; p++) {
-		if (*p != '%') {
-			write(1, p, 1);
-			continue;
-		}
+	const char *p = fmt;
+	while (*p != '\0') {
+		// Copy the literal run up to the next directive in one step.
+		const char *run = p;
+		while (*p != '\0' && *p != '%')
+			p++;
+		emit(run, p - run);
+		if (*p == '\0')
+			break;
 
 		p++;
 		switch (*p) {
@@ -108,19 +281,83 @@ void print(const char *fmt, ...) {
 			break;
 		case 's': {
 			char *c = va_arg(args, char *);
-			write(1, c, strlen(c));
+			emit(c, strlen(c));
 			break;
 		}
-		case 'S':
-			put(va_arg(args, String));
+		case 'S': {
+			String s = va_arg(args, String);
+			emit(s.ptr, s.len);
 			break;
+		}
 		case '%':
-			write(1, "%", 1);
+			emit("%", 1);
 			break;
 		default:
-			write(1, p - 1, 1);
-			p--;
+			emit("%", 1);
+			continue;
 		}
+		p++;
 	}
 	va_end(args);
-}
\ No newline at end of file
+	commit();
+}
+
+// --- REPORT ---
+
+// Emits a string literal without counting its length by hand.
+#define EMIT_LIT(s) emit(s, sizeof(s) - 1)
+
+static void put_u64(const char *label, u64 n) {
+	emit(label, strlen(label));
+	put_i64((long long)n);
+}
+
+void report(const Arena *a) {
+	out_init();
+	put_u64("[arena] used ", a->len);
+	put_u64(" / ", a->cap);
+	EMIT_LIT(" bytes\n");
+
+#ifdef CAMELOT_ARENA_STATS
+	const ArenaStats *st = a->stats;
+	if (st) {
+		put_u64("[arena] peak ", st->peak);
+		put_u64(" | allocs ", st->count);
+		put_u64(" | requested ", st->bytes);
+		put_u64(" | padding ", st->padding);
+		put_u64(" | failures ", st->failures);
+		EMIT_LIT("\n");
+
+		EMIT_LIT("[arena] sizes (<= bytes: allocs)\n");
+		for (u64 b = 0; b < 64; b++) {
+			if (st->histogram[b] == 0)
+				continue;
+			put_u64("    ", b ? (1ULL << b) - 1 : 0);
+			put_u64(": ", st->histogram[b]);
+			EMIT_LIT("\n");
+		}
+
+		EMIT_LIT("[arena] sites (count / bytes)\n");
+		for (u64 i = 0; i < ARENA_STATS_SITES && st->sites[i].count; i++) {
+			const ArenaSite *site = &st->sites[i];
+			const char *file = site->file ? site->file : "(untracked)";
+			EMIT_LIT("    ");
+			emit(file, strlen(file));
+			put_u64(":", site->line);
+			put_u64("  ", site->count);
+			put_u64(" / ", site->bytes);
+			EMIT_LIT("\n");
+		}
+
+		if (st->failures) {
+			const char *file = st->oom.file ? st->oom.file : "(untracked)";
+			EMIT_LIT("[arena] first OOM at ");
+			emit(file, strlen(file));
+			put_u64(":", st->oom.line);
+			put_u64(" requesting ", st->oom.bytes);
+			EMIT_LIT(" bytes\n");
+		}
+	}
+#endif
+	commit();
+}
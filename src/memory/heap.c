@@ -0,0 +1,452 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <stddef.h> // offsetof
+#include <string.h>
+#include "camelot.h"
+// clang-format on
+
+/*
+ * The block layout, size-class mapping and split/merge logic below are
+ * adapted from the Two Level Segregated Fit allocator (tlsf.c, v3.1) by
+ * Matthew Conte, http://tlsf.baisoku.org, distributed under this notice:
+ *
+ * Copyright (c) 2006-2016, Matthew Conte
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL MATTHEW CONTE BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Two-Level Segregated Fit: sizes map to a (first, second) level list in
+// O(1) through two bitmaps, so alloc and recycle never walk a list.
+
+// --- CONSTANTS ---
+#define ALIGN 8
+#define SL_LOG2 4
+#define FL_SHIFT (SL_LOG2 + 3)
+#define SMALL_BLOCK (1ULL << FL_SHIFT)
+#define FL_MAX (HEAP_FL_COUNT + FL_SHIFT - 1)
+
+#define BLOCK_FREE 1ULL
+#define BLOCK_PREV_FREE 2ULL
+
+#define HEAP_DEFAULT_REGION (256 * 1024)
+
+// A block header. 'prev_phys' lives in the last word of the previous block
+// and is only meaningful while that block is free; the free-list links
+// overlay the payload of free blocks.
+typedef struct HeapBlock {
+	struct HeapBlock *prev_phys;
+	u64 size; // Payload bytes | BLOCK_FREE | BLOCK_PREV_FREE
+	struct HeapBlock *next_free;
+	struct HeapBlock *prev_free;
+} HeapBlock;
+
+#define OVERHEAD sizeof(u64)
+#define START_OFFSET (offsetof(HeapBlock, size) + sizeof(u64))
+#define BLOCK_MIN (sizeof(HeapBlock) - sizeof(HeapBlock *))
+#define BLOCK_MAX (1ULL << FL_MAX)
+
+// --- BLOCK HELPERS ---
+
+static u64 block_size(const HeapBlock *b) {
+	return b->size & ~(BLOCK_FREE | BLOCK_PREV_FREE);
+}
+
+static void block_set_size(HeapBlock *b, u64 size) {
+	b->size = size | (b->size & (BLOCK_FREE | BLOCK_PREV_FREE));
+}
+
+static bool block_is_free(const HeapBlock *b) {
+	return b->size & BLOCK_FREE;
+}
+
+static bool block_is_prev_free(const HeapBlock *b) {
+	return b->size & BLOCK_PREV_FREE;
+}
+
+static void *block_to_ptr(const HeapBlock *b) {
+	return (u8 *)b + START_OFFSET;
+}
+
+static HeapBlock *block_from_ptr(const void *p) {
+	return (HeapBlock *)((u8 *)p - START_OFFSET);
+}
+
+static HeapBlock *block_at(const void *p, i64 offset) {
+	return (HeapBlock *)((uintptr_t)p + offset);
+}
+
+static HeapBlock *block_next(const HeapBlock *b) {
+	return block_at(block_to_ptr(b), (i64)(block_size(b) - OVERHEAD));
+}
+
+static HeapBlock *block_link_next(HeapBlock *b) {
+	HeapBlock *next = block_next(b);
+	next->prev_phys = b;
+	return next;
+}
+
+static void block_mark_free(HeapBlock *b) {
+	HeapBlock *next = block_link_next(b);
+	next->size |= BLOCK_PREV_FREE;
+	b->size |= BLOCK_FREE;
+}
+
+static void block_mark_used(HeapBlock *b) {
+	HeapBlock *next = block_next(b);
+	next->size &= ~BLOCK_PREV_FREE;
+	b->size &= ~BLOCK_FREE;
+}
+
+static u64 align_up(u64 n, u64 to) {
+	return (n + to - 1) & ~(to - 1);
+}
+
+static u64 adjust_request(u64 size) {
+	if (size == 0 || size >= BLOCK_MAX)
+		return 0;
+	u64 aligned = align_up(size, ALIGN);
+	return aligned < BLOCK_MIN ? BLOCK_MIN : aligned;
+}
+
+// --- SIZE CLASSES ---
+
+static int msb(u64 n) {
+	return 63 - __builtin_clzll(n);
+}
+
+static void mapping_insert(u64 size, int *fl, int *sl) {
+	if (size < SMALL_BLOCK) {
+		*fl = 0;
+		*sl = (int)(size / (SMALL_BLOCK / HEAP_SL_COUNT));
+	} else {
+		int f = msb(size);
+		*sl = (int)((size >> (f - SL_LOG2)) ^ (1ULL << SL_LOG2));
+		*fl = f - (FL_SHIFT - 1);
+	}
+}
+
+// Rounds up to the next class so any block found is large enough.
+static u64 mapping_round(u64 size) {
+	if (size >= SMALL_BLOCK)
+		size += (1ULL << (msb(size) - SL_LOG2)) - 1;
+	return size;
+}
+
+// --- FREE LISTS ---
+
+static HeapBlock *search_suitable(Heap *h, int *fl, int *sl) {
+	u32 sl_map = h->sl_bitmap[*fl] & (~0U << *sl);
+	if (!sl_map) {
+		u64 fl_map = h->fl_bitmap & (~0ULL << (*fl + 1));
+		if (!fl_map)
+			return NULL;
+		*fl = __builtin_ctzll(fl_map);
+		sl_map = h->sl_bitmap[*fl];
+	}
+	*sl = __builtin_ctz(sl_map);
+	return h->lists[*fl][*sl];
+}
+
+static void remove_free(Heap *h, HeapBlock *b, int fl, int sl) {
+	HeapBlock *prev = b->prev_free;
+	HeapBlock *next = b->next_free;
+	if (next)
+		next->prev_free = prev;
+	if (prev)
+		prev->next_free = next;
+
+	if (h->lists[fl][sl] == b) {
+		h->lists[fl][sl] = next;
+		if (!next) {
+			h->sl_bitmap[fl] &= ~(1U << sl);
+			if (!h->sl_bitmap[fl])
+				h->fl_bitmap &= ~(1ULL << fl);
+		}
+	}
+}
+
+static void insert_free(Heap *h, HeapBlock *b, int fl, int sl) {
+	HeapBlock *current = h->lists[fl][sl];
+	b->next_free = current;
+	b->prev_free = NULL;
+	if (current)
+		current->prev_free = b;
+
+	h->lists[fl][sl] = b;
+	h->fl_bitmap |= 1ULL << fl;
+	h->sl_bitmap[fl] |= 1U << sl;
+}
+
+static void block_remove(Heap *h, HeapBlock *b) {
+	int fl, sl;
+	mapping_insert(block_size(b), &fl, &sl);
+	remove_free(h, b, fl, sl);
+}
+
+static void block_insert(Heap *h, HeapBlock *b) {
+	int fl, sl;
+	mapping_insert(block_size(b), &fl, &sl);
+	insert_free(h, b, fl, sl);
+}
+
+// --- SPLIT / MERGE ---
+
+static bool block_can_split(const HeapBlock *b, u64 size) {
+	return block_size(b) >= sizeof(HeapBlock) + size;
+}
+
+static HeapBlock *block_split(HeapBlock *b, u64 size) {
+	HeapBlock *rest = block_at(block_to_ptr(b), (i64)(size - OVERHEAD));
+	u64 rest_size = block_size(b) - (size + OVERHEAD);
+
+	rest->size = rest_size;
+	block_set_size(b, size);
+	block_mark_free(rest);
+	return rest;
+}
+
+static HeapBlock *block_absorb(HeapBlock *prev, HeapBlock *b) {
+	prev->size += block_size(b) + OVERHEAD;
+	block_link_next(prev);
+	return prev;
+}
+
+static HeapBlock *merge_prev(Heap *h, HeapBlock *b) {
+	if (block_is_prev_free(b)) {
+		HeapBlock *prev = b->prev_phys;
+		block_remove(h, prev);
+		b = block_absorb(prev, b);
+	}
+	return b;
+}
+
+static HeapBlock *merge_next(Heap *h, HeapBlock *b) {
+	HeapBlock *next = block_next(b);
+	if (block_is_free(next)) {
+		block_remove(h, next);
+		b = block_absorb(b, next);
+	}
+	return b;
+}
+
+static void trim_free(Heap *h, HeapBlock *b, u64 size) {
+	if (block_can_split(b, size)) {
+		HeapBlock *rest = block_split(b, size);
+		block_link_next(b);
+		rest->size |= BLOCK_PREV_FREE;
+		block_insert(h, rest);
+	}
+}
+
+static void trim_used(Heap *h, HeapBlock *b, u64 size) {
+	if (block_can_split(b, size)) {
+		HeapBlock *rest = block_split(b, size);
+		rest->size &= ~BLOCK_PREV_FREE;
+		rest = merge_next(h, rest);
+		block_insert(h, rest);
+	}
+}
+
+static HeapBlock *trim_free_leading(Heap *h, HeapBlock *b, u64 size) {
+	HeapBlock *rest = b;
+	if (block_can_split(b, size)) {
+		rest = block_split(b, size - OVERHEAD);
+		rest->size |= BLOCK_PREV_FREE;
+		block_link_next(b);
+		block_insert(h, b);
+	}
+	return rest;
+}
+
+// --- REGIONS ---
+
+// Adds an arena block as one free block followed by a zero-size sentinel.
+static bool grow(Heap *h, u64 need) {
+	u64 bytes = mapping_round(need) + 4 * sizeof(HeapBlock);
+	if (bytes < h->region)
+		bytes = h->region;
+
+	u8 *mem = arena.alloc_aligned(h->source, bytes, ALIGN);
+	if (!mem)
+		return false;
+
+	u64 pool = (bytes - 2 * OVERHEAD) & ~(u64)(ALIGN - 1);
+	HeapBlock *b = block_at(mem, -(i64)OVERHEAD);
+	b->size = pool | BLOCK_FREE;
+	block_insert(h, b);
+
+	HeapBlock *sentinel = block_link_next(b);
+	sentinel->size = BLOCK_PREV_FREE;
+	return true;
+}
+
+static HeapBlock *locate_free(Heap *h, u64 size) {
+	if (!size)
+		return NULL;
+
+	for (int attempt = 0; attempt < 2; attempt++) {
+		int fl, sl;
+		mapping_insert(mapping_round(size), &fl, &sl);
+		if (fl < HEAP_FL_COUNT) {
+			HeapBlock *b = search_suitable(h, &fl, &sl);
+			if (b) {
+				remove_free(h, b, fl, sl);
+				return b;
+			}
+		}
+		if (attempt == 0 && !grow(h, size))
+			return NULL;
+	}
+	return NULL;
+}
+
+static void *prepare_used(Heap *h, HeapBlock *b, u64 size) {
+	if (!b)
+		return NULL;
+	trim_free(h, b, size);
+	block_mark_used(b);
+	h->used += block_size(b);
+	return block_to_ptr(b);
+}
+
+// --- INTERNAL LINKAGE (memory.c) ---
+
+void *heap_alloc_aligned(Heap *h, u64 size, u64 align) {
+	// Size 0 still gets a minimum block, like a bump arena handing out a
+	// valid pointer. Only an oversized request leaves 'adjust' at 0.
+	u64 adjust = adjust_request(size ? size : 1);
+	if (!adjust || align <= ALIGN)
+		return prepare_used(h, locate_free(h, adjust), adjust);
+
+	// Over-allocate, then give the leading gap back as its own free block.
+	u64 gap_min = sizeof(HeapBlock);
+	HeapBlock *b = locate_free(h, adjust_request(adjust + align + gap_min));
+	if (!b)
+		return NULL;
+
+	uintptr_t ptr = (uintptr_t)block_to_ptr(b);
+	uintptr_t aligned = align_up(ptr, align);
+	u64 gap = aligned - ptr;
+
+	if (gap && gap < gap_min) {
+		u64 offset = gap_min - gap > align ? gap_min - gap : align;
+		aligned = align_up(aligned + offset, align);
+		gap = aligned - ptr;
+	}
+	if (gap)
+		b = trim_free_leading(h, b, gap);
+
+	return prepare_used(h, b, adjust);
+}
+
+void heap_recycle(Heap *h, void *ptr) {
+	if (!ptr)
+		return;
+
+	HeapBlock *b = block_from_ptr(ptr);
+	h->used -= block_size(b);
+	block_mark_free(b);
+	b = merge_prev(h, b);
+	b = merge_next(h, b);
+	block_insert(h, b);
+}
+
+void *heap_resize_aligned(Heap *h, void *ptr, u64 size, u64 align) {
+	if (!ptr)
+		return heap_alloc_aligned(h, size, align);
+	if (size == 0) {
+		heap_recycle(h, ptr);
+		return NULL;
+	}
+
+	HeapBlock *b = block_from_ptr(ptr);
+	HeapBlock *next = block_next(b);
+	u64 current = block_size(b);
+	u64 combined = current + block_size(next) + OVERHEAD;
+	u64 adjust = adjust_request(size);
+
+	if (adjust == 0)
+		return NULL;
+
+	// Move only if the neighbour cannot absorb the growth.
+	if (adjust > current && (!block_is_free(next) || adjust > combined)) {
+		void *p = heap_alloc_aligned(h, size, align);
+		if (p) {
+			memcpy(p, ptr, current < size ? current : size);
+			heap_recycle(h, ptr);
+		}
+		return p;
+	}
+
+	h->used -= current;
+	if (adjust > current) {
+		merge_next(h, b);
+		block_mark_used(b);
+	}
+	trim_used(h, b, adjust);
+	h->used += block_size(b);
+	return ptr;
+}
+
+// --- INTERNAL IMPLEMENTATION ---
+
+static Heap internal_create(Arena *a, u64 region) {
+	return (Heap){
+		.source = a,
+		.region = region ? region : HEAP_DEFAULT_REGION,
+	};
+}
+
+static void *internal_alloc(Heap *h, u64 size) {
+	return heap_alloc_aligned(h, size, ALIGN);
+}
+
+static void *internal_resize(Heap *h, void *ptr, u64 size) {
+	return heap_resize_aligned(h, ptr, size, ALIGN);
+}
+
+static Arena internal_arena(Heap *h) {
+	return (Arena){
+		.status = OK,
+		.heap = h,
+	};
+}
+
+// --- NAMESPACE ---
+
+const HeapNamespace heap = {
+	.create = internal_create,
+	.alloc = internal_alloc,
+	.resize = internal_resize,
+	.recycle = heap_recycle,
+	.arena = internal_arena,
+};
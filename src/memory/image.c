@@ -0,0 +1,178 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+#define _DEFAULT_SOURCE // MAP_FIXED_NOREPLACE
+
+// clang-format off
+#include <fcntl.h>    // open
+#include <string.h>
+#include <sys/mman.h> // mmap, msync, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // pread, ftruncate, close, sysconf
+#include "camelot.h"
+// clang-format on
+
+// --- CONSTANTS ---
+#define IMAGE_MAGIC 0x544f4c454d4143ULL // "CAMELOT"
+#define IMAGE_VERSION 1
+
+// First page of the file. The arena data follows at 'header' bytes.
+typedef struct ArenaImage {
+	u64 magic;
+	u64 version;
+	u64 header; // Header size (one page) so data stays page-aligned
+	u64 base;	// Address the data must be mapped at for pointers to hold
+	u64 cap;
+	u64 len;
+	u64 root;	  // Offset of the root object + 1 (0 = none)
+	u64 checksum; // Over data[0, len) at snapshot time
+} ArenaImage;
+
+// --- HELPERS ---
+
+// Word-at-a-time mixing; detects torn or stale data, not tampering.
+static u64 checksum(const u8 *p, u64 len) {
+	u64 h = 0x9E3779B97F4A7C15ULL ^ len;
+	u64 i = 0;
+	for (; i + 8 <= len; i += 8) {
+		u64 w;
+		memcpy(&w, p + i, 8);
+		h = (h ^ w) * 0xFF51AFD7ED558CCDULL;
+		h ^= h >> 32;
+	}
+	for (; i < len; i++)
+		h = (h ^ p[i]) * 0x100000001B3ULL;
+	return h;
+}
+
+// What the file holds; only empty files and stale images are formatted.
+typedef enum {
+	IMAGE_EMPTY,   // New or zero-length file
+	IMAGE_FOREIGN, // Not written by Camelot
+	IMAGE_STALE,   // Camelot image with a bad header, version or checksum
+	IMAGE_BUSY,	   // Valid image whose recorded address is already taken
+	IMAGE_PLACED,  // Valid image mapped at its recorded address
+} ImageState;
+
+// Verifies data[0, len) through a temporary mapping at any address.
+static bool intact(int fd, const ArenaImage *hdr) {
+	void *mem = mmap(NULL, hdr->header + hdr->cap, PROT_READ, MAP_SHARED, fd, 0);
+	if (mem == MAP_FAILED)
+		return true; // Cannot tell; keep the file
+	bool ok = checksum((u8 *)mem + hdr->header, hdr->len) == hdr->checksum;
+	munmap(mem, hdr->header + hdr->cap);
+	return ok;
+}
+
+// Maps a previously snapshotted image at its recorded address.
+static ImageState reload(int fd, u64 page, ArenaImage **out) {
+	ArenaImage hdr = {0};
+	struct stat st;
+
+	if (fstat(fd, &st) != 0)
+		return IMAGE_FOREIGN;
+	if (st.st_size == 0)
+		return IMAGE_EMPTY;
+	if (pread(fd, &hdr, sizeof(hdr), 0) < (ssize_t)sizeof(hdr.magic) || hdr.magic != IMAGE_MAGIC)
+		return IMAGE_FOREIGN;
+	if (hdr.version != IMAGE_VERSION || hdr.header != page ||
+		(u64)st.st_size != hdr.header + hdr.cap || hdr.len > hdr.cap)
+		return IMAGE_STALE;
+
+	void *want = (void *)(uintptr_t)(hdr.base - hdr.header);
+	void *mem = mmap(want, hdr.header + hdr.cap, PROT_READ | PROT_WRITE,
+					 MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+	if (mem != MAP_FAILED && mem != want) {
+		munmap(mem, hdr.header + hdr.cap); // Kernel ignored the hint
+		mem = MAP_FAILED;
+	}
+	if (mem == MAP_FAILED)
+		return intact(fd, &hdr) ? IMAGE_BUSY : IMAGE_STALE;
+
+	if (checksum((u8 *)mem + hdr.header, hdr.len) != hdr.checksum) {
+		munmap(mem, hdr.header + hdr.cap);
+		return IMAGE_STALE;
+	}
+	*out = mem;
+	return IMAGE_PLACED;
+}
+
+// Truncates the file and maps a fresh, zeroed image.
+static ArenaImage *format(int fd, u64 page, u64 size) {
+	if (ftruncate(fd, 0) != 0 || ftruncate(fd, (off_t)(page + size)) != 0)
+		return NULL;
+
+	void *mem = mmap(NULL, page + size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mem == MAP_FAILED)
+		return NULL;
+
+	ArenaImage *img = mem;
+	*img = (ArenaImage){
+		.magic = IMAGE_MAGIC,
+		.version = IMAGE_VERSION,
+		.header = page,
+		.base = (u64)(uintptr_t)mem + page,
+		.cap = size,
+	};
+	return img;
+}
+
+// --- INTERNAL LINKAGE (memory.c) ---
+
+Arena image_map(const char *path, u64 size) {
+	u64 page = (u64)sysconf(_SC_PAGESIZE);
+	size = (size + page - 1) & ~(page - 1);
+
+	int fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (fd < 0)
+		return (Arena){.status = FILE_NOT_FOUND};
+
+	// A valid image that cannot be placed is left untouched.
+	ArenaImage *img = NULL;
+	ImageState state = reload(fd, page, &img);
+	if ((state == IMAGE_EMPTY || state == IMAGE_STALE) && size > 0)
+		img = format(fd, page, size);
+	close(fd); // The mapping keeps the file referenced
+
+	if (!img)
+		return (Arena){.status = IO_ERROR};
+
+	return (Arena){
+		.buf = (u8 *)img + img->header,
+		.len = img->len,
+		.cap = img->cap,
+		.status = OK,
+		.image = img,
+	};
+}
+
+void image_release(Arena *a) {
+	ArenaImage *img = a->image;
+	munmap(img, img->header + img->cap);
+	a->image = NULL;
+}
+
+Result image_snapshot(Arena *a, void *root) {
+	ArenaImage *img = a->image;
+	if (!img)
+		return IO_ERROR;
+
+	img->len = a->len;
+	img->root = root ? (u64)((u8 *)root - a->buf) + 1 : 0;
+	img->checksum = checksum(a->buf, a->len);
+
+	return msync(img, img->header + a->len, MS_SYNC) == 0 ? OK : IO_ERROR;
+}
+
+void *image_root(Arena *a) {
+	ArenaImage *img = a->image;
+	if (!img || img->root == 0)
+		return NULL;
+	return a->buf + (img->root - 1);
+}
@@ -8,24 +8,138 @@
  */
 
 #define ALLOW_UNSAFE
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS, madvise
 
 // clang-format off
+#include <fcntl.h>    // open
+#include <pthread.h>  // pthread_once, pthread_key_create
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h> // mmap, mprotect, madvise, munmap
+#include <unistd.h>   // sysconf, read, close
 #include "camelot.h"
 // clang-format on
 
+// Below this many used bytes, ZERO_LAZY scrubs with memset; above it the
+// page-aligned part is handed back to the OS instead.
+#define LAZY_ZERO_THRESHOLD (64 * 1024)
+
+// Virtual range reserved for each per-thread scratch arena.
+#define SCRATCH_RESERVE (1ULL << 32)
+
+// Huge page size targeted by PAGES_HUGE (x86-64 / AArch64 default).
+#define HUGE_PAGE (2ULL * 1024 * 1024)
+
+// --- EXTERNAL LINKAGE ---
+extern void shared_retire(Arena *a);
+extern bool shared_refill(Arena *a, u64 need);
+extern Arena image_map(const char *path, u64 size);
+extern void image_release(Arena *a);
+extern Result image_snapshot(Arena *a, void *root);
+extern void *image_root(Arena *a);
+extern void *heap_alloc_aligned(Heap *h, u64 size, u64 align);
+extern void *heap_resize_aligned(Heap *h, void *ptr, u64 size, u64 align);
+
+// --- INSTRUMENTATION ---
+
+#ifdef CAMELOT_ARENA_STATS
+static ArenaStats *stats_of(Arena *a) {
+	if (!a->stats)
+		a->stats = calloc(1, sizeof(ArenaStats));
+	return a->stats;
+}
+
+static ArenaSite *stats_site(ArenaStats *st) {
+	ArenaSite *last = &st->sites[ARENA_STATS_SITES - 1];
+	for (ArenaSite *s = st->sites; s < last; s++) {
+		if (s->count == 0) {
+			s->file = st->next_file;
+			s->line = st->next_line;
+			return s;
+		}
+		if (s->file == st->next_file && s->line == st->next_line)
+			return s;
+	}
+	return last; // Overflow bucket
+}
+
+static void stats_record(Arena *a, u64 size, u64 padding, bool ok) {
+	ArenaStats *st = stats_of(a);
+	if (!st)
+		return;
+
+	if (!ok) {
+		if (st->failures++ == 0)
+			st->oom = (ArenaSite){.file = st->next_file, .line = st->next_line, .bytes = size};
+	} else {
+		st->count++;
+		st->bytes += size;
+		st->padding += padding;
+		st->histogram[size ? 64 - __builtin_clzll(size) : 0]++;
+		if (a->len > st->peak)
+			st->peak = a->len;
+		ArenaSite *site = stats_site(st);
+		site->count++;
+		site->bytes += size;
+	}
+	st->next_file = NULL;
+	st->next_line = 0;
+}
+#define STATS_RECORD(a, size, padding, ok) stats_record(a, size, padding, ok)
+#else
+#define STATS_RECORD(a, size, padding, ok) ((void)0)
+#endif
+
+// --- HELPERS ---
+
+static u64 page_size(void) {
+	return (u64)sysconf(_SC_PAGESIZE);
+}
+
+static u64 round_up(u64 n, u64 to) {
+	return (n + to - 1) & ~(to - 1);
+}
+
+// Faults pages in ahead of use so first touches do not stall.
+static void prefault(u8 *p, u64 n) {
+#ifdef MADV_POPULATE_WRITE
+	if (madvise(p, n, MADV_POPULATE_WRITE) == 0)
+		return;
+#endif
+	volatile u8 *v = p;
+	for (u64 i = 0; i < n; i += page_size())
+		v[i] = v[i];
+}
+
+// Commits enough of the reserved range to hold 'needed' bytes.
+// Grows geometrically so repeated small allocations stay cheap.
+static bool commit_to(Arena *a, u64 needed) {
+	if (a->reserved == 0 || needed > a->reserved)
+		return false;
+
+	u64 target = a->cap * 2 > needed ? a->cap * 2 : needed;
+	target = round_up(target, page_size());
+	if (target > a->reserved)
+		target = a->reserved;
+
+	if (mprotect(a->buf + a->cap, target - a->cap, PROT_READ | PROT_WRITE) != 0)
+		return false;
+	if (a->pages & PAGES_PREFAULT)
+		prefault(a->buf + a->cap, target - a->cap);
+
+	a->cap = target;
+	return true;
+}
+
 // --- INTERNAL IMPLEMENTATION ---
 
 static Arena internal_create(u64 size) {
-	void *mem = malloc(size);
+	// Zeroed for security; calloc skips the memset for fresh OS pages.
+	void *mem = calloc(1, size);
 	if (!mem) {
 		return (Arena){.status = OOM};
 	}
 
-	// Zero out immediately for security
-	memset(mem, 0, size);
-
 	return (Arena){
 		.buf = (u8 *)mem,
 		.cap = size,
@@ -34,47 +148,317 @@ static Arena internal_create(u64 size) {
 	};
 }
 
+// Explicit huge pages from the hugetlbfs pool, fully committed up front.
+static u8 *map_hugetlb(u64 size, bool populate) {
+#ifdef MAP_HUGETLB
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (populate ? MAP_POPULATE : 0);
+	void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+	return mem == MAP_FAILED ? NULL : (u8 *)mem;
+#else
+	(void)size;
+	(void)populate;
+	return NULL;
+#endif
+}
+
+// Reserves an inaccessible range; huge-page hinted ranges start on a
+// huge-page boundary so the kernel can actually use them.
+static u8 *map_reserve(u64 size, bool huge_aligned) {
+	u64 slop = huge_aligned ? HUGE_PAGE : 0;
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+	void *mem = mmap(NULL, size + slop, PROT_NONE, flags, -1, 0);
+	if (mem == MAP_FAILED)
+		return NULL;
+	if (!slop)
+		return mem;
+
+	u8 *start = (u8 *)round_up((u64)(uintptr_t)mem, HUGE_PAGE);
+	u64 head = (u64)(start - (u8 *)mem);
+	if (head)
+		munmap(mem, head);
+	munmap(start + size, slop - head);
+	return start;
+}
+
+// MADV_HUGEPAGE succeeds even when THP is off system-wide, so the advice
+// only counts when the active mode ("[always]" or "[madvise]") honours it.
+static bool thp_enabled(void) {
+	char mode[128] = {0};
+	int fd = open("/sys/kernel/mm/transparent_hugepage/enabled", O_RDONLY);
+	if (fd < 0)
+		return false;
+	ssize_t n = read(fd, mode, sizeof(mode) - 1);
+	close(fd);
+	return n > 0 && !strstr(mode, "[never]");
+}
+
+static Arena internal_reserve(ArenaOptions opts) {
+	u64 page = page_size();
+	u64 reserve = round_up(opts.reserve > opts.commit ? opts.reserve : opts.commit, page);
+	if (reserve == 0) {
+		return (Arena){.status = OOM};
+	}
+
+	bool huge = opts.pages & PAGES_HUGE;
+	bool populate = opts.pages & PAGES_PREFAULT;
+	u64 commit = round_up(opts.commit, page);
+	u64 floor = round_up(opts.floor, page);
+	u32 honored = 0;
+
+	// 1. Explicit huge pages: the whole range is committed and never shrinks.
+	u8 *mem = huge ? map_hugetlb(round_up(reserve, HUGE_PAGE), populate) : NULL;
+	if (mem) {
+		reserve = round_up(reserve, HUGE_PAGE);
+		commit = reserve;
+		floor = reserve;
+		honored = PAGES_HUGETLB | (populate ? PAGES_PREFAULT : 0);
+	} else {
+		// 2. Regular reservation, optionally hinted for transparent huge pages.
+		mem = map_reserve(reserve, huge);
+		if (!mem) {
+			return (Arena){.status = OOM};
+		}
+#ifdef MADV_HUGEPAGE
+		if (huge && madvise(mem, reserve, MADV_HUGEPAGE) == 0 && thp_enabled())
+			honored |= PAGES_THP;
+#endif
+		if (commit > 0 && mprotect(mem, commit, PROT_READ | PROT_WRITE) != 0) {
+			munmap(mem, reserve);
+			return (Arena){.status = OOM};
+		}
+		if (populate && commit > 0) {
+			prefault(mem, commit);
+			honored |= PAGES_PREFAULT;
+		}
+	}
+
+	return (Arena){
+		.buf = mem,
+		.cap = commit,
+		.len = 0,
+		.status = OK,
+		.reserved = reserve,
+		.floor = floor < reserve ? floor : reserve,
+		.zero = opts.zero,
+		.align = opts.align,
+		.pages = honored,
+	};
+}
+
 static void internal_release(Arena *a) {
+#ifdef CAMELOT_ARENA_STATS
+	free(a->stats);
+	a->stats = NULL;
+#endif
+	if (a->shared) {
+		shared_retire(a); // Views only detach; the region owns the memory
+		return;
+	}
 	if (a->buf) {
-		free(a->buf);
+		if (a->image)
+			image_release(a);
+		else if (a->reserved)
+			munmap(a->buf, a->reserved);
+		else
+			free(a->buf);
 		a->buf = NULL;
 	}
 	a->cap = 0;
 	a->len = 0;
+	a->reserved = 0;
 }
 
 static void internal_clear(Arena *a) {
-	// SECURITY: Null the memory as requested before resetting cursor
-	if (a->buf && a->len > 0) {
-		memset(a->buf, 0, a->len);
+	if (!a->buf) {
+		a->len = 0;
+		return;
+	}
+
+	// Pages above the floor go back to the OS; they are zero-filled when
+	// committed again, so only the retained part needs scrubbing.
+	if (a->reserved && a->cap > a->floor) {
+		madvise(a->buf + a->floor, a->cap - a->floor, MADV_DONTNEED);
+		mprotect(a->buf + a->floor, a->cap - a->floor, PROT_NONE);
+		a->cap = a->floor;
 	}
+
+	u64 used = a->len < a->cap ? a->len : a->cap;
 	a->len = 0;
+
+	if (a->zero == ZERO_NONE || used == 0)
+		return;
+
+	// Private anonymous pages dropped with MADV_DONTNEED refault as zero
+	// pages, so only the unaligned tail needs an explicit memset.
+	if (a->zero == ZERO_LAZY && a->reserved && used >= LAZY_ZERO_THRESHOLD) {
+		u64 whole = used & ~(page_size() - 1);
+		if (madvise(a->buf, whole, MADV_DONTNEED) == 0) {
+			memset(a->buf + whole, 0, used - whole);
+			return;
+		}
+	}
+
+	// SECURITY: Null the memory as requested before resetting cursor
+	memset(a->buf, 0, used);
 }
 
-static void *internal_alloc(Arena *a, u64 size) {
+static void *internal_alloc_aligned(Arena *a, u64 size, u64 align) {
 	if (a->status != OK)
 		return NULL;
 
+	// Round up to a power of two so the mask below is valid.
+	if (align == 0)
+		align = 8;
+	if (align & (align - 1))
+		align = 1ULL << (64 - __builtin_clzll(align));
+
+	if (a->heap) {
+		void *p = heap_alloc_aligned(a->heap, size, align);
+		if (!p)
+			a->status = OOM;
+		return p;
+	}
+
 	uintptr_t address = (uintptr_t)a->buf + a->len;
-	// 8-byte alignment
-	u64 padding = (8 - (address % 8)) % 8;
+	u64 padding = (align - (address & (align - 1))) & (align - 1);
 
-	if (a->len + padding + size > a->cap) {
-		a->status = OOM;
-		return NULL;
+	if (a->len + padding + size > a->cap && !commit_to(a, a->len + padding + size)) {
+		// Views of a SharedArena move to a fresh chunk instead of failing.
+		if (!a->shared || !shared_refill(a, size + align)) {
+			a->status = OOM;
+			STATS_RECORD(a, size, padding, false);
+			return NULL;
+		}
+		padding = (align - ((uintptr_t)a->buf & (align - 1))) & (align - 1);
 	}
 
 	a->len += padding;
 	void *p = &a->buf[a->len];
 	a->len += size;
+	STATS_RECORD(a, size, padding, true);
 	return p;
 }
 
+static void *internal_alloc(Arena *a, u64 size) {
+	return internal_alloc_aligned(a, size, a->align);
+}
+
+static void *internal_extend(Arena *a, void *ptr, u64 old_size, u64 new_size) {
+	if (!ptr)
+		return internal_alloc(a, new_size);
+	if (a->status != OK)
+		return NULL;
+
+	uintptr_t address = (uintptr_t)ptr;
+	uintptr_t base = (uintptr_t)a->buf;
+	u64 align = address & (~address + 1); // Lowest set bit
+	if (align > CACHE_LINE)
+		align = CACHE_LINE;
+
+	if (a->heap) {
+		// heap.resize recycles on size 0; a view shrinks in place like a bump arena.
+		void *p = heap_resize_aligned(a->heap, ptr, new_size ? new_size : 1, align);
+		if (!p)
+			a->status = OOM;
+		return p;
+	}
+
+	// Tail block: move the cursor instead of copying.
+	if (a->buf && address >= base && address - base + old_size == a->len) {
+		u64 offset = address - base;
+		if (new_size <= old_size) {
+			if (a->zero != ZERO_NONE)
+				memset((u8 *)ptr + new_size, 0, old_size - new_size);
+			a->len = offset + new_size;
+			return ptr;
+		}
+		if (offset + new_size <= a->cap || commit_to(a, offset + new_size)) {
+			a->len = offset + new_size;
+			STATS_RECORD(a, new_size - old_size, 0, true);
+			return ptr;
+		}
+	}
+
+	if (new_size <= old_size)
+		return ptr;
+
+	void *p = internal_alloc_aligned(a, new_size, align > a->align ? align : a->align);
+	if (p)
+		memcpy(p, ptr, old_size);
+	return p;
+}
+
+static ArenaMark internal_mark(Arena *a) {
+	return (ArenaMark){.arena = a, .len = a->len};
+}
+
+static void internal_rewind(ArenaMark m) {
+	Arena *a = m.arena;
+	if (!a || m.len >= a->len)
+		return;
+
+	if (a->zero != ZERO_NONE)
+		memset(a->buf + m.len, 0, a->len - m.len);
+	a->len = m.len;
+}
+
+static Arena *internal_trace(Arena *a, const char *file, u32 line) {
+#ifdef CAMELOT_ARENA_STATS
+	ArenaStats *st = stats_of(a);
+	if (st) {
+		st->next_file = file;
+		st->next_line = line;
+	}
+#else
+	(void)file;
+	(void)line;
+#endif
+	return a;
+}
+
+// --- SCRATCH ---
+
+static _Thread_local Arena scratch_pool[2];
+static pthread_key_t scratch_key;
+static pthread_once_t scratch_once = PTHREAD_ONCE_INIT;
+
+static void scratch_destroy(void *pool) {
+	Arena *slots = pool;
+	internal_release(&slots[0]);
+	internal_release(&slots[1]);
+}
+
+static void scratch_key_init(void) {
+	pthread_key_create(&scratch_key, scratch_destroy);
+}
+
+static ArenaMark internal_scratch(Arena *conflict) {
+	Arena *s = (conflict == &scratch_pool[0]) ? &scratch_pool[1] : &scratch_pool[0];
+
+	if (!s->buf) {
+		*s = internal_reserve((ArenaOptions){.reserve = SCRATCH_RESERVE, .zero = ZERO_NONE});
+		// Registers the thread-exit hook so worker threads do not leak.
+		pthread_once(&scratch_once, scratch_key_init);
+		pthread_setspecific(scratch_key, scratch_pool);
+	}
+	return internal_mark(s);
+}
+
 // --- NAMESPACE ---
 
 const ArenaNamespace arena = {
 	.create = internal_create,
+	.reserve = internal_reserve,
+	.map = image_map,
+	.snapshot = image_snapshot,
+	.root = image_root,
 	.release = internal_release,
 	.clear = internal_clear,
 	.alloc = internal_alloc,
+	.alloc_aligned = internal_alloc_aligned,
+	.extend = internal_extend,
+	.mark = internal_mark,
+	.rewind = internal_rewind,
+	.scratch = internal_scratch,
+	.trace = internal_trace,
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <string.h>
+#include "camelot.h"
+// clang-format on
+
+#define POOL_DEFAULT_SLAB 64
+
+// Per-thread caches in front of the free list are deliberately omitted: the
+// free list is never shared, so there is no contention for a cache to hide.
+
+// --- INTERNAL IMPLEMENTATION ---
+
+static Pool internal_create(Arena *a, u64 slot_size, u64 slab_slots) {
+	// Every slot must be able to hold the free-list link.
+	if (slot_size < sizeof(void *))
+		slot_size = sizeof(void *);
+	slot_size = (slot_size + 7) & ~7ULL;
+
+	return (Pool){
+		.source = a,
+		.slot_size = slot_size,
+		.slab_slots = slab_slots ? slab_slots : POOL_DEFAULT_SLAB,
+	};
+}
+
+static void *internal_alloc(Pool *p) {
+	void *slot = p->free_list;
+
+	if (slot) {
+		p->free_list = *(void **)slot;
+		if (p->source->zero != ZERO_NONE)
+			*(void **)slot = NULL; // Rest of the slot was scrubbed on recycle
+	} else {
+		if (p->slab_next == p->slab_end) {
+			u64 bytes = p->slot_size * p->slab_slots;
+			u8 *slab = arena.alloc(p->source, bytes);
+			if (!slab)
+				return NULL;
+			p->slab_next = slab;
+			p->slab_end = slab + bytes;
+		}
+		slot = p->slab_next;
+		p->slab_next += p->slot_size;
+	}
+
+	p->live++;
+	return slot;
+}
+
+static void internal_recycle(Pool *p, void *slot) {
+	if (!slot)
+		return;
+
+	if (p->source->zero != ZERO_NONE)
+		memset(slot, 0, p->slot_size);
+	*(void **)slot = p->free_list;
+	p->free_list = slot;
+	p->live--;
+}
+
+// --- NAMESPACE ---
+
+const PoolNamespace pool = {
+	.create = internal_create,
+	.alloc = internal_alloc,
+	.recycle = internal_recycle,
+};
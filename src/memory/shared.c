@@ -0,0 +1,122 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS, MAP_NORESERVE
+
+// clang-format off
+#include <stdatomic.h>
+#include <stddef.h>   // NULL
+#include <sys/mman.h> // mmap, munmap
+#include "camelot.h"
+// clang-format on
+
+#define SHARED_DEFAULT_CHUNK (64 * 1024)
+
+// --- HELPERS ---
+
+// Claims 'size' bytes aligned to 'align' with a CAS loop (lock-free).
+static void *carve(SharedArena *s, u64 size, u64 align) {
+	u64 off = atomic_load_explicit(&s->carved, memory_order_relaxed);
+	u64 start, end;
+
+	do {
+		uintptr_t at = (uintptr_t)s->buf + off;
+		start = off + ((align - (at & (align - 1))) & (align - 1));
+		end = start + size;
+		if (end > s->cap)
+			return NULL;
+	} while (!atomic_compare_exchange_weak_explicit(&s->carved, &off, end, memory_order_relaxed,
+													memory_order_relaxed));
+
+	return s->buf + start;
+}
+
+// --- INTERNAL LINKAGE (memory.c) ---
+
+// Hands a view's bytes back to the shared usage counter.
+void shared_retire(Arena *a) {
+	if (a->len > 0)
+		atomic_fetch_add_explicit(&a->shared->used, a->len, memory_order_relaxed);
+	a->buf = NULL;
+	a->len = 0;
+	a->cap = 0;
+}
+
+// Moves a view onto a fresh chunk large enough for 'need' bytes.
+bool shared_refill(Arena *a, u64 need) {
+	SharedArena *s = a->shared;
+	u64 size = need > s->chunk ? need : s->chunk;
+
+	u8 *chunk = carve(s, size, CACHE_LINE);
+	if (!chunk)
+		return false;
+
+	shared_retire(a);
+	a->buf = chunk;
+	a->cap = size;
+	return true;
+}
+
+// --- INTERNAL IMPLEMENTATION ---
+
+static SharedArena internal_create(u64 size, u64 chunk) {
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+	void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+	if (size == 0 || mem == MAP_FAILED) {
+		return (SharedArena){.status = OOM};
+	}
+
+	return (SharedArena){
+		.buf = (u8 *)mem,
+		.cap = size,
+		.chunk = chunk ? chunk : SHARED_DEFAULT_CHUNK,
+		.status = OK,
+	};
+}
+
+static void internal_release(SharedArena *s) {
+	if (s->buf) {
+		munmap(s->buf, s->cap);
+		s->buf = NULL;
+	}
+	s->cap = 0;
+	atomic_store(&s->carved, 0);
+	atomic_store(&s->used, 0);
+}
+
+static Arena internal_attach(SharedArena *s) {
+	return (Arena){
+		.status = s->buf ? OK : OOM,
+		.shared = s,
+	};
+}
+
+static void *internal_alloc(SharedArena *s, u64 size) {
+	void *p = carve(s, size, 8);
+	if (!p) {
+		atomic_store_explicit(&s->status, OOM, memory_order_relaxed);
+		return NULL;
+	}
+	atomic_fetch_add_explicit(&s->used, size, memory_order_relaxed);
+	return p;
+}
+
+static u64 internal_usage(SharedArena *s) {
+	return atomic_load_explicit(&s->used, memory_order_relaxed);
+}
+
+// --- NAMESPACE ---
+
+const SharedNamespace shared = {
+	.create = internal_create,
+	.release = internal_release,
+	.attach = internal_attach,
+	.alloc = internal_alloc,
+	.usage = internal_usage,
+};
@@ -39,6 +39,23 @@ static String internal_join(Arena *a, String s1, String s2) {
 	return (String){.ptr = buf, .len = new_len};
 }
 
+static String internal_append(Arena *a, String s, String tail) {
+	// Only a null-terminated tail block can be grown in place.
+	if (!s.ptr || s.ptr + s.len + 1 != a->buf + a->len)
+		return internal_join(a, s, tail);
+
+	u64 new_len = s.len + tail.len;
+	u8 *buf = arena.extend(a, s.ptr, s.len + 1, new_len + 1);
+
+	if (!buf)
+		return (String){0};
+
+	memcpy(buf + s.len, tail.ptr, tail.len);
+	buf[new_len] = '\0';
+
+	return (String){.ptr = buf, .len = new_len};
+}
+
 static bool internal_equal(String a, String b) {
 	if (a.len != b.len)
 		return false;
@@ -52,5 +69,6 @@ static bool internal_equal(String a, String b) {
 const StringNamespace string = {
 	.from = internal_from,
 	.join = internal_join,
+	.append = internal_append,
 	.equal = internal_equal,
 };
\ No newline at end of file
@@ -1,74 +1,852 @@
-/*
- * This Source Code Form is subject to the terms of the Mozilla Public
- * License, v. 2.0. If a copy of the MPL was not distributed with this
- * file, You can obtain one at http://mozilla.org/MPL/2.0/.
- *
- * Governed by the Avant Systems Canon (ASC-1.1).
- * Compliance is mandatory for all contributions.
- */
-
-#include "tests.h"
-
-// --- LIST TESTS ---
-
-TEST(test_paged_list) {
-	Arena a = arena.create(1024 * 10);
-
-	List nums = list.create(&a, sizeof(int));
-
-	for (int i = 0; i < 300; i++) {
-		list.push(&nums, &i);
-	}
-
-	REQUIRE(nums.count == 300);
-
-	int *val1 = list.get(&nums, 10);
-	REQUIRE(val1 != NULL);
-	if (val1) {
-		REQUIRE(*val1 == 10);
-	}
-
-	int *val2 = list.get(&nums, 260);
-	REQUIRE(val2 != NULL);
-	if (val2) {
-		REQUIRE(*val2 == 260);
-	}
-
-	list.remove(&nums, 10);
-	int *new_val1 = list.get(&nums, 10);
-
-	REQUIRE(new_val1 != NULL);
-	if (new_val1) {
-		REQUIRE(*new_val1 == 299);
-	}
-	REQUIRE(nums.count == 299);
-
-	arena.release(&a);
-}
-
-// --- TABLE TESTS ---
-
-TEST(test_hash_table) {
-	Arena a = arena.create(4096);
-
-	Table cfg = table.create(&a, 16);
-
-	int val1 = 100;
-	table.put(&cfg, string.from("Width"), &val1);
-
-	int *got1 = table.get(&cfg, string.from("Width"));
-	REQUIRE(got1 != NULL);
-	if (got1) {
-		REQUIRE(*got1 == 100);
-	}
-
-	int *missing = table.get(&cfg, string.from("Depth"));
-	REQUIRE(missing == NULL);
-
-	arena.release(&a);
-}
-
-void test_ds() {
-	RUN(test_paged_list);
-	RUN(test_hash_table);
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Governed by the Avant Systems Canon (ASC-1.1).
+ * Compliance is mandatory for all contributions.
+ */
+
+// clang-format off
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include "tests.h"
+// clang-format on
+
+// --- LIST TESTS ---
+
+TEST(test_paged_list) {
+	Arena a = arena.create(1 << 16);
+
+	List nums = list.create(&a, sizeof(int));
+
+	for (int i = 0; i < 300; i++) {
+		list.push(&nums, &i);
+	}
+
+	REQUIRE(nums.count == 300);
+
+	int *val1 = list.get(&nums, 10);
+	REQUIRE(val1 != NULL);
+	if (val1) {
+		REQUIRE(*val1 == 10);
+	}
+
+	int *val2 = list.get(&nums, 260);
+	REQUIRE(val2 != NULL);
+	if (val2) {
+		REQUIRE(*val2 == 260);
+	}
+
+	list.remove(&nums, 10);
+	int *new_val1 = list.get(&nums, 10);
+
+	REQUIRE(new_val1 != NULL);
+	if (new_val1) {
+		REQUIRE(*new_val1 == 299);
+	}
+	REQUIRE(nums.count == 299);
+
+	arena.release(&a);
+}
+
+TEST(test_list_bulk) {
+	Arena a = arena.create(1 << 16);
+	List nums = list.create(&a, sizeof(int));
+
+	// Reserved pages absorb later pushes without touching the Arena.
+	REQUIRE(list.reserve(&nums, 1000) == OK);
+	u64 used = a.len;
+
+	int src[700];
+	for (int i = 0; i < 700; i++) {
+		src[i] = i;
+	}
+	REQUIRE(list.push_n(&nums, src, 700) == 700);
+
+	int *slot = list.push_slot(&nums);
+	REQUIRE(slot != NULL);
+	if (slot) {
+		*slot = 700;
+	}
+	REQUIRE(a.len == used);
+	REQUIRE(nums.count == 701);
+
+	List copy = list.create(&a, sizeof(int));
+	REQUIRE(list.extend(&copy, &nums) == 701);
+	bool ordered = true;
+	for (u64 i = 0; i < copy.count; i++) {
+		int *v = list.get(&copy, i);
+		if (!v || *v != (int)i)
+			ordered = false;
+	}
+	REQUIRE(ordered);
+
+	List wide = list.create(&a, sizeof(u64));
+	REQUIRE(list.extend(&wide, &nums) == 0);
+
+	// Self-extend copies the items present at the call, once.
+	REQUIRE(list.extend(&copy, &copy) == 701);
+	REQUIRE(copy.count == 1402);
+	int *twin = list.get(&copy, 701 + 500);
+	REQUIRE(twin != NULL && *twin == 500);
+
+	arena.release(&a);
+}
+
+TEST(test_list_recycle) {
+	Arena a = arena.create(1 << 17);
+	List q = list.create_paged(&a, sizeof(u32), 256);
+
+	// Queue-like cycles reuse pages: no Arena growth after the first.
+	u64 used = 0;
+	for (u32 cycle = 0; cycle < 8; cycle++) {
+		for (u32 i = 0; i < 500; i++) {
+			list.push(&q, &i);
+		}
+		if (cycle == 0)
+			used = a.len;
+		REQUIRE(a.len == used);
+		list.clear(&q);
+	}
+	REQUIRE(q.count == 0);
+
+	for (u32 i = 0; i < 100; i++) {
+		list.push(&q, &i);
+	}
+	list.truncate(&q, 40);
+	list.truncate(&q, 90); // Never grows
+	REQUIRE(q.count == 40);
+
+	u32 top = 0;
+	REQUIRE(list.pop(&q, &top) && top == 39);
+	REQUIRE(q.count == 39);
+	list.clear(&q);
+	REQUIRE(!list.pop(&q, &top));
+
+	arena.release(&a);
+}
+
+TEST(test_list_geometry) {
+	Arena a = arena.create(1 << 17);
+
+	// Pages hold a power-of-two item count within the byte budget.
+	List flags = list.create(&a, sizeof(u8));
+	REQUIRE(flags.page_mask + 1 == LIST_PAGE_BYTES);
+	List records = list.create(&a, 4096);
+	REQUIRE(records.page_mask + 1 == LIST_PAGE_BYTES / 4096);
+	List huge = list.create(&a, LIST_PAGE_BYTES * 2);
+	REQUIRE(huge.page_shift == 0);
+
+	List rows = list.create_paged(&a, 24, 4096);
+	REQUIRE(rows.page_shift == 7);
+
+	// Index math stays correct across many small pages.
+	List small = list.create_paged(&a, sizeof(u32), 64);
+	for (u32 i = 0; i < 100; i++) {
+		list.push(&small, &i);
+	}
+	REQUIRE(small.pages_len == 7);
+	u32 *v = list.get(&small, 99);
+	REQUIRE(v != NULL && *v == 99);
+
+	u64 sum = 0;
+	LIST_FOREACH(u32, x, &small) { sum += *x; }
+	REQUIRE(sum == 99 * 100 / 2);
+
+	List copy = list.create(&a, sizeof(u32));
+	REQUIRE(list.extend(&copy, &small) == 100);
+	v = list.get(&copy, 64);
+	REQUIRE(v != NULL && *v == 64);
+
+	arena.release(&a);
+}
+
+TEST(test_list_cursor) {
+	Arena a = arena.create(1 << 16);
+	List l = list.create(&a, sizeof(u64));
+	for (u64 i = 0; i < 1000; i++) {
+		list.push(&l, &i);
+	}
+
+	u64 sum = 0, seen = 0;
+	LIST_FOREACH(u64, x, &l) {
+		REQUIRE(*x == seen);
+		sum += *x;
+		seen++;
+	}
+	REQUIRE(seen == 1000 && sum == 999 * 1000 / 2);
+
+	// Starting mid-page yields a short first span.
+	ListCursor c = list.cursor(&l, 300);
+	REQUIRE(list.next(&c));
+	REQUIRE(c.at == 300 && c.len == 700);
+	REQUIRE(*(u64 *)c.ptr == 300);
+
+	u64 expect = 999;
+	LIST_FOREACH_REVERSE(u64, x, &l) {
+		REQUIRE(*x == expect);
+		expect--;
+	}
+	REQUIRE(expect == UINT64_MAX);
+
+	c = list.rcursor(&l, 5);
+	REQUIRE(list.next(&c) && c.at == 0 && c.len == 6);
+	REQUIRE(!list.next(&c));
+
+	// 'break' ends the whole walk, even past a page boundary.
+	List paged = list.create_paged(&a, sizeof(u64), 32 * sizeof(u64));
+	for (u64 i = 0; i < 200; i++) {
+		list.push(&paged, &i);
+	}
+	u64 visited = 0;
+	LIST_FOREACH(u64, x, &paged) {
+		if (*x % 2)
+			continue;
+		visited++;
+		if (*x == 50)
+			break;
+	}
+	REQUIRE(visited == 26);
+
+	visited = 0;
+	LIST_FOREACH_FROM(u64, x, &paged, 10) {
+		visited++;
+		if (*x == 40)
+			break;
+	}
+	REQUIRE(visited == 31);
+
+	visited = 0;
+	LIST_FOREACH_REVERSE(u64, x, &paged) {
+		visited++;
+		if (*x == 150)
+			break;
+	}
+	REQUIRE(visited == 50);
+
+	List empty = list.create(&a, sizeof(u64));
+	LIST_FOREACH(u64, x, &empty) {
+		REQUIRE(x == NULL); // Never runs
+	}
+	c = list.cursor(&empty, 0);
+	REQUIRE(!list.next(&c));
+
+	arena.release(&a);
+}
+
+static void double_span(void *items, u64 len, u64 at, void *ctx) {
+	(void)at, (void)ctx;
+	f64 *x = items;
+	for (u64 i = 0; i < len; i++) {
+		x[i] *= 2.0;
+	}
+}
+
+static void sum_span(void *acc, const void *items, u64 len, void *ctx) {
+	(void)ctx;
+	const f64 *x = items;
+	for (u64 i = 0; i < len; i++) {
+		*(f64 *)acc += x[i];
+	}
+}
+
+static void sum_merge(void *acc, const void *part, void *ctx) {
+	(void)ctx;
+	*(f64 *)acc += *(const f64 *)part;
+}
+
+static void truncate_span(void *out, const void *in, u64 len, void *ctx) {
+	(void)ctx;
+	const f64 *x = in;
+	u32 *y = out;
+	for (u64 i = 0; i < len; i++) {
+		y[i] = (u32)x[i];
+	}
+}
+
+typedef struct {
+	List *inner;
+	_Atomic u64 seen;
+} Nest;
+
+static void count_span(void *items, u64 len, u64 at, void *ctx) {
+	(void)items, (void)at;
+	atomic_fetch_add(&((Nest *)ctx)->seen, len);
+}
+
+static void nested_span(void *items, u64 len, u64 at, void *ctx) {
+	(void)items, (void)len, (void)at;
+	Nest *n = ctx;
+	list.parallel_for(n->inner, count_span, n, 4);
+}
+
+TEST(test_list_parallel) {
+	Arena a = arena.create(1 << 21);
+	List l = list.create_paged(&a, sizeof(f64), 4096);
+	for (u64 i = 0; i < 100000; i++) {
+		f64 v = (f64)i + 0.1;
+		list.push(&l, &v);
+	}
+
+	list.parallel_for(&l, double_span, NULL, 4);
+	f64 *x = list.get(&l, 77777);
+	REQUIRE(x != NULL && *x == 2.0 * (77777 + 0.1));
+
+	// Same bits regardless of worker count.
+	f64 one = 0.0, many = 0.0;
+	REQUIRE(list.parallel_reduce(&l, &one, sizeof(f64), sum_span, sum_merge, NULL, 1) == OK);
+	REQUIRE(list.parallel_reduce(&l, &many, sizeof(f64), sum_span, sum_merge, NULL, 8) == OK);
+	REQUIRE(one == many);
+	REQUIRE(one > 9.99e9 && one < 1.001e10);
+
+	// Destination geometry differs from the source.
+	List out = list.create(&a, sizeof(u32));
+	u32 head = 7;
+	list.push(&out, &head);
+	REQUIRE(list.parallel_map(&out, &l, truncate_span, NULL, 0) == OK);
+	REQUIRE(out.count == 100001);
+	bool mapped = true;
+	for (u64 i = 0; i < l.count; i++) {
+		u32 *y = list.get(&out, i + 1);
+		if (!y || *y != (u32)(2.0 * ((f64)i + 0.1)))
+			mapped = false;
+	}
+	REQUIRE(mapped);
+
+	// Calls from inside a unit run on that unit's thread; helpers are
+	// parked, not restarted, between the repeated calls.
+	List inner = list.create_paged(&a, sizeof(u64), 64);
+	for (u64 i = 0; i < 1000; i++) {
+		list.push(&inner, &i);
+	}
+	Nest nest = {.inner = &inner};
+	for (int round = 0; round < 20; round++) {
+		list.parallel_for(&l, nested_span, &nest, 4);
+	}
+	u64 pages = (l.count + l.page_mask) >> l.page_shift;
+	REQUIRE(atomic_load(&nest.seen) == 20 * pages * inner.count);
+
+	arena.release(&a);
+}
+
+static int cmp_u64(const void *a, const void *b, void *ctx) {
+	(void)ctx;
+	u64 x = *(const u64 *)a, y = *(const u64 *)b;
+	return (x > y) - (x < y);
+}
+
+static bool sorted_u64(List *l) {
+	for (u64 i = 1; i < l->count; i++) {
+		if (*(u64 *)list.get(l, i - 1) > *(u64 *)list.get(l, i))
+			return false;
+	}
+	return true;
+}
+
+TEST(test_list_sort) {
+	Arena a = arena.create(1 << 20);
+	List l = list.create_paged(&a, sizeof(u64), 1024);
+
+	u64 seed = 12345, sum = 0;
+	for (u64 i = 0; i < 20000; i++) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		u64 v = (seed >> 33) % 5000; // Plenty of duplicates
+		sum += v;
+		list.push(&l, &v);
+	}
+
+	List copy = list.create(&a, sizeof(u64));
+	list.extend(&copy, &l);
+
+	// Merges recycle pages between levels, but each ends up back in place.
+	void *first = l.pages[0], *last = l.pages[(l.count - 1) >> l.page_shift];
+	REQUIRE(list.sort(&l, cmp_u64, NULL, 4) == OK);
+	REQUIRE(sorted_u64(&l));
+	REQUIRE(l.pages[0] == first && l.pages[(l.count - 1) >> l.page_shift] == last);
+	u64 check = 0;
+	LIST_FOREACH(u64, x, &l) { check += *x; }
+	REQUIRE(check == sum);
+
+	REQUIRE(list.radix_sort(&copy, 0, sizeof(u64)) == OK);
+	REQUIRE(sorted_u64(&copy));
+	bool same = true;
+	for (u64 i = 0; i < l.count; i++) {
+		if (*(u64 *)list.get(&l, i) != *(u64 *)list.get(&copy, i))
+			same = false;
+	}
+	REQUIRE(same);
+	REQUIRE(list.radix_sort(&copy, 4, sizeof(u64)) == INVALID_KEY);
+
+	u64 key = 2500;
+	u64 at = list.lower_bound(&l, &key, cmp_u64, NULL);
+	REQUIRE(at == l.count || *(u64 *)list.get(&l, at) >= key);
+	REQUIRE(at == 0 || *(u64 *)list.get(&l, at - 1) < key);
+	key = 999999;
+	REQUIRE(list.lower_bound(&l, &key, cmp_u64, NULL) == l.count);
+	REQUIRE(list.search(&l, &key, cmp_u64, NULL) == NULL);
+
+	arena.release(&a);
+}
+
+LIST_DEFINE(u64, U64List)
+
+#define U64_LESS(a, b) ((a) < (b))
+LIST_DEFINE_SORT(u64, U64List, U64_LESS)
+
+TEST(test_typed_sort) {
+	Arena a = arena.create(1 << 17);
+	U64List nums = U64List_create(&a);
+
+	u64 seed = 7;
+	for (u64 i = 0; i < 5000; i++) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		U64List_push(&nums, seed >> 40);
+	}
+	U64List_sort(&nums);
+	REQUIRE(sorted_u64(&nums.base));
+
+	u64 *mid = U64List_get(&nums, 2500);
+	u64 i = U64List_lower_bound(&nums, *mid);
+	REQUIRE(i <= 2500 && *U64List_get(&nums, i) == *mid);
+
+	arena.release(&a);
+}
+
+TEST(test_typed_list) {
+	Arena a = arena.create(1 << 16);
+	U64List nums = U64List_create(&a);
+
+	for (u64 i = 0; i < 600; i++) {
+		U64List_push(&nums, i * 3);
+	}
+	REQUIRE(nums.base.count == 600);
+
+	u64 *x = U64List_get(&nums, 511);
+	REQUIRE(x != NULL && *x == 511 * 3);
+	REQUIRE(U64List_get(&nums, 600) == NULL);
+
+	// Same layout as List: both views agree.
+	u64 *y = list.get(&nums.base, 300);
+	REQUIRE(y == U64List_get(&nums, 300));
+
+	U64List_remove(&nums, 0);
+	x = U64List_get(&nums, 0);
+	REQUIRE(x != NULL && *x == 599 * 3);
+	REQUIRE(nums.base.count == 599);
+
+	u64 last = 0;
+	REQUIRE(U64List_pop(&nums, &last) && last == 598 * 3);
+	REQUIRE(nums.base.count == 598);
+
+	arena.release(&a);
+}
+
+// --- JOURNAL TESTS ---
+
+#define JOURNAL_WORKERS 4
+#define JOURNAL_ITEMS 20000
+
+typedef struct {
+	Journal *j;
+	u64 id;
+	bool ok;
+} JournalJob;
+
+static void *journal_producer(void *arg) {
+	JournalJob *job = arg;
+	job->ok = true;
+	for (u64 i = 0; i < JOURNAL_ITEMS; i++) {
+		u64 v = (job->id << 32) | (i + 1);
+		if (!journal.push(job->j, &v))
+			job->ok = false;
+	}
+	return NULL;
+}
+
+static void *journal_reader(void *arg) {
+	JournalJob *job = arg;
+	job->ok = true;
+	for (u64 seen = 0; seen < JOURNAL_WORKERS * JOURNAL_ITEMS;) {
+		u64 n = journal.count(job->j);
+		if (n == seen)
+			sched_yield();
+		for (; seen < n; seen++) {
+			u64 *v = journal.get(job->j, seen);
+			if (!v || (*v & 0xffffffff) == 0)
+				job->ok = false;
+		}
+	}
+	return NULL;
+}
+
+TEST(test_journal) {
+	SharedArena region = shared.create(1 << 24, 0);
+	Journal j = journal.create(&region, sizeof(u64), JOURNAL_WORKERS * JOURNAL_ITEMS);
+	REQUIRE(j.status == OK);
+	REQUIRE(journal.reserve(&j, 1000) == OK);
+
+	pthread_t threads[JOURNAL_WORKERS + 1];
+	JournalJob jobs[JOURNAL_WORKERS + 1];
+	for (u64 i = 0; i <= JOURNAL_WORKERS; i++) {
+		jobs[i] = (JournalJob){.j = &j, .id = i};
+		pthread_create(&threads[i], NULL, i < JOURNAL_WORKERS ? journal_producer : journal_reader,
+					   &jobs[i]);
+	}
+	for (u64 i = 0; i <= JOURNAL_WORKERS; i++) {
+		pthread_join(threads[i], NULL);
+		REQUIRE(jobs[i].ok);
+	}
+	REQUIRE(journal.count(&j) == JOURNAL_WORKERS * JOURNAL_ITEMS);
+
+	// Each producer's items appear in its own push order.
+	u64 next[JOURNAL_WORKERS] = {0};
+	bool ordered = true;
+	for (u64 i = 0; i < journal.count(&j); i++) {
+		u64 v = *(u64 *)journal.get(&j, i);
+		if ((v & 0xffffffff) != ++next[v >> 32])
+			ordered = false;
+	}
+	REQUIRE(ordered);
+
+	u64 extra = 1;
+	REQUIRE(!journal.push(&j, &extra)); // At capacity
+	REQUIRE(journal.get(&j, JOURNAL_WORKERS * JOURNAL_ITEMS) == NULL);
+
+	shared.release(&region);
+}
+
+// --- FRAME TESTS ---
+
+typedef struct {
+	u32 id;
+	f64 price;
+	u8 side;
+} Trade;
+
+TEST(test_frame) {
+	Arena a = arena.create(1 << 18);
+	FrameColumn cols[] = {
+		FRAME_FIELD(Trade, id),
+		FRAME_FIELD(Trade, price),
+		FRAME_FIELD(Trade, side),
+	};
+	Frame f = frame.create(&a, cols, 3);
+	REQUIRE(f.status == OK);
+
+	for (u32 i = 0; i < 5000; i++) {
+		Trade t = {.id = i, .price = i * 0.5, .side = (u8)(i & 1)};
+		REQUIRE(frame.push(&f, &t));
+	}
+	REQUIRE(f.rows == 5000);
+
+	// Columns share rows-per-page despite different widths.
+	REQUIRE(f.columns[0].page_shift == f.columns[1].page_shift);
+	REQUIRE(f.columns[2].page_shift == f.columns[1].page_shift);
+
+	Trade t = {0};
+	REQUIRE(frame.get(&f, 4321, &t));
+	REQUIRE(t.id == 4321 && t.price == 4321 * 0.5 && t.side == 1);
+	REQUIRE(!frame.get(&f, 5000, &t));
+	u32 *id = frame.cell(&f, 0, 17);
+	REQUIRE(id != NULL && *id == 17);
+
+	// Lockstep scan over two columns.
+	f64 buys = 0.0;
+	u64 rows = 0;
+	FrameCursor c = frame.cursor(&f, 0);
+	while (frame.next(&c)) {
+		f64 *price = frame.span(&c, 1);
+		u8 *side = frame.span(&c, 2);
+		for (u64 i = 0; i < c.len; i++) {
+			buys += side[i] ? 0.0 : price[i];
+		}
+		rows += c.len;
+	}
+	REQUIRE(rows == 5000);
+	REQUIRE(buys == 0.5 * (2 * 2499 * 2500 / 2));
+
+	arena.release(&a);
+}
+
+// --- QUEUE TESTS ---
+
+TEST(test_deque) {
+	Arena a = arena.create(1 << 18);
+	Deque d = deque.create(&a, sizeof(u64));
+
+	// Mixed ends force growth while the front sits mid-page.
+	for (u64 i = 0; i < 10000; i++) {
+		REQUIRE(i % 3 ? deque.push_back(&d, &i) : deque.push_front(&d, &i));
+	}
+	REQUIRE(d.count == 10000);
+	u64 front = 0, back = 0;
+	REQUIRE(deque.pop_front(&d, &front) && front == 9999);
+	REQUIRE(deque.pop_back(&d, &back) && back == 9998);
+	u64 *x = deque.get(&d, 0);
+	REQUIRE(x != NULL && *x == 9996);
+
+	// Once the ring has turned a full lap, every page is reused.
+	bool fifo = true;
+	deque.clear(&d);
+	u64 used = 0;
+	for (u64 cycle = 0; cycle < 50; cycle++) {
+		if (cycle == 25)
+			used = a.len;
+		for (u64 i = 0; i < 3000; i++) {
+			deque.push_back(&d, &i);
+		}
+		for (u64 i = 0; i < 3000; i++) {
+			u64 v;
+			if (!deque.pop_front(&d, &v) || v != i)
+				fifo = false;
+		}
+	}
+	REQUIRE(fifo);
+	REQUIRE(a.len == used); // Pages recycled by the ring
+	REQUIRE(!deque.pop_front(&d, &front));
+
+	arena.release(&a);
+}
+
+#define RING_ITEMS 200000
+
+static void *ring_producer(void *arg) {
+	Ring *r = arg;
+	for (u64 i = 1; i <= RING_ITEMS;) {
+		if (ring.push(r, &i))
+			i++;
+		else
+			sched_yield();
+	}
+	return NULL;
+}
+
+#define QUEUE_THREADS 4
+#define QUEUE_ITEMS 50000
+
+typedef struct {
+	Queue *q;
+	u64 sum;
+} QueueJob;
+
+static void *queue_producer(void *arg) {
+	QueueJob *job = arg;
+	for (u64 i = 1; i <= QUEUE_ITEMS;) {
+		if (queue.push(job->q, &i))
+			i++;
+		else
+			sched_yield();
+	}
+	return NULL;
+}
+
+static void *queue_consumer(void *arg) {
+	QueueJob *job = arg;
+	for (u64 got = 0; got < QUEUE_ITEMS;) {
+		u64 v;
+		if (queue.pop(job->q, &v)) {
+			job->sum += v;
+			got++;
+		} else {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+TEST(test_queues) {
+	Arena a = arena.create(1 << 16);
+
+	Ring r = ring.create(&a, sizeof(u64), 100);
+	REQUIRE(r.status == OK && r.mask == 127);
+	pthread_t producer;
+	pthread_create(&producer, NULL, ring_producer, &r);
+	bool ordered = true;
+	for (u64 expect = 1; expect <= RING_ITEMS;) {
+		u64 v;
+		if (ring.pop(&r, &v)) {
+			if (v != expect)
+				ordered = false;
+			expect++;
+		} else {
+			sched_yield();
+		}
+	}
+	pthread_join(producer, NULL);
+	REQUIRE(ordered);
+
+	Queue q = queue.create(&a, sizeof(u64), 256);
+	REQUIRE(q.status == OK);
+	pthread_t threads[2 * QUEUE_THREADS];
+	QueueJob jobs[2 * QUEUE_THREADS];
+	for (int i = 0; i < 2 * QUEUE_THREADS; i++) {
+		jobs[i] = (QueueJob){.q = &q};
+		pthread_create(&threads[i], NULL, i < QUEUE_THREADS ? queue_producer : queue_consumer,
+					   &jobs[i]);
+	}
+	u64 total = 0;
+	for (int i = 0; i < 2 * QUEUE_THREADS; i++) {
+		pthread_join(threads[i], NULL);
+		total += jobs[i].sum;
+	}
+	REQUIRE(total == QUEUE_THREADS * (u64)QUEUE_ITEMS * (QUEUE_ITEMS + 1) / 2);
+
+	u64 v = 0;
+	REQUIRE(!queue.pop(&q, &v));
+	for (u64 i = 0; i < 256; i++) {
+		REQUIRE(queue.push(&q, &i));
+	}
+	REQUIRE(!queue.push(&q, &v)); // Full
+
+	arena.release(&a);
+}
+
+// --- TABLE TESTS ---
+
+TEST(test_hash_table) {
+	Arena a = arena.create(4096);
+
+	Table cfg = table.create(&a, 16);
+
+	int val1 = 100;
+	table.put(&cfg, string.from("Width"), &val1);
+
+	int *got1 = table.get(&cfg, string.from("Width"));
+	REQUIRE(got1 != NULL);
+	if (got1) {
+		REQUIRE(*got1 == 100);
+	}
+
+	int *missing = table.get(&cfg, string.from("Depth"));
+	REQUIRE(missing == NULL);
+
+	arena.release(&a);
+}
+
+TEST(test_table_growth_in_place) {
+	// Keys live elsewhere so the entry array stays the arena's tail.
+	Arena keys = arena.create(1 << 16);
+	Arena a = arena.create(1 << 17);
+	Table t = table.create(&a, 16);
+
+	int vals[1000];
+	String names[1000];
+	for (int i = 0; i < 1000; i++) {
+		u8 *k = arena.alloc(&keys, 8);
+		for (int d = 0; d < 8; d++) {
+			k[d] = 'a' + ((i >> (d * 2)) & 3) + d;
+		}
+		names[i] = (String){.ptr = k, .len = 8};
+		vals[i] = i;
+		table.put(&t, names[i], &vals[i]);
+	}
+
+	// Every resize extended in place: only the final array is resident.
+	REQUIRE(a.status == OK);
+	REQUIRE(a.len <= (sizeof(Entry) + 1) * t.cap + TABLE_GROUP + CACHE_LINE);
+
+	for (int i = 0; i < 1000; i++) {
+		int *got = table.get(&t, names[i]);
+		REQUIRE(got != NULL && *got == i);
+	}
+
+	arena.release(&a);
+	arena.release(&keys);
+}
+
+TEST(test_table_probing) {
+	Arena a = arena.create(1 << 20);
+	Table t = table.create(&a, 20);
+	REQUIRE(t.cap == 32);
+
+	// Fill to just under 7/8 of the final capacity, then probe misses.
+	static u64 keys[7000];
+	for (u64 i = 0; i < 7000; i++) {
+		keys[i] = i * 0x9e3779b97f4a7c15ULL;
+		table.put(&t, (String){.ptr = (u8 *)&keys[i], .len = 8}, &keys[i]);
+	}
+	REQUIRE(t.count == 7000 && t.cap == 8192);
+
+	bool hits = true, misses = true;
+	for (u64 i = 0; i < 7000; i++) {
+		u64 *v = table.get(&t, (String){.ptr = (u8 *)&keys[i], .len = 8});
+		if (v != &keys[i])
+			hits = false;
+		u64 absent = keys[i] + 1;
+		if (table.get(&t, (String){.ptr = (u8 *)&absent, .len = 8}) != NULL)
+			misses = false;
+	}
+	REQUIRE(hits && misses);
+
+	// Overwrite keeps the count.
+	u64 other = 0;
+	table.put(&t, (String){.ptr = (u8 *)&keys[5], .len = 8}, &other);
+	REQUIRE(t.count == 7000);
+	REQUIRE(table.get(&t, (String){.ptr = (u8 *)&keys[5], .len = 8}) == &other);
+
+	arena.release(&a);
+}
+
+// --- HASH TESTS ---
+
+TEST(test_hash) {
+	u8 buf[160];
+	for (u32 i = 0; i < sizeof(buf); i++) {
+		buf[i] = (u8)(i * 37 + 11);
+	}
+
+	// Every prefix length (all code paths) hashes differently.
+	u64 seen[129];
+	bool distinct = true;
+	for (u64 n = 0; n <= 128; n++) {
+		seen[n] = hash.bytes(buf, n, 42);
+		for (u64 k = 0; k < n; k++) {
+			if (seen[k] == seen[n])
+				distinct = false;
+		}
+	}
+	REQUIRE(distinct);
+
+	// Content, not address or alignment, decides the hash.
+	u8 copy[160];
+	for (u32 i = 0; i < 100; i++) {
+		copy[i + 1] = buf[i];
+	}
+	REQUIRE(hash.bytes(copy + 1, 100, 42) == hash.bytes(buf, 100, 42));
+	REQUIRE(hash.bytes(buf, 100, 42) != hash.bytes(buf, 100, 43));
+	REQUIRE(hash.str(string.from("camelot"), 7) == hash.bytes("camelot", 7, 7));
+	REQUIRE(hash.word(1, 0) != hash.word(2, 0));
+	REQUIRE(hash.seed() != hash.seed());
+
+	// Tables draw their own seeds but agree on contents.
+	Arena a = arena.create(1 << 16);
+	Table t1 = table.create(&a, 16), t2 = table.create(&a, 16);
+	REQUIRE(t1.seed != t2.seed);
+	int v = 5;
+	table.put(&t1, string.from("k"), &v);
+	table.put(&t2, string.from("k"), &v);
+	REQUIRE(table.get(&t1, string.from("k")) == table.get(&t2, string.from("k")));
+	arena.release(&a);
+}
+
+void test_ds() {
+	RUN(test_paged_list);
+	RUN(test_list_bulk);
+	RUN(test_list_recycle);
+	RUN(test_list_geometry);
+	RUN(test_list_cursor);
+	RUN(test_list_parallel);
+	RUN(test_list_sort);
+	RUN(test_typed_list);
+	RUN(test_typed_sort);
+	RUN(test_journal);
+	RUN(test_frame);
+	RUN(test_deque);
+	RUN(test_queues);
+	RUN(test_hash_table);
+	RUN(test_table_growth_in_place);
+	RUN(test_table_probing);
+	RUN(test_hash);
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 
 // clang-format off
 #include <fcntl.h> // open, O_RDONLY
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h> // close
@@ -39,6 +40,25 @@ static void cleanup_stdin() {
 	remove("test_stdin.tmp");
 }
 
+// --- HELPERS (For Print Tests) ---
+
+static int capture_stdout() {
+	fflush(stdout);
+	int saved = dup(1);
+	int fd = open("test_stdout.tmp", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd != -1) {
+		dup2(fd, 1);
+		close(fd);
+	}
+	return saved;
+}
+
+static void restore_stdout(int saved) {
+	dup2(saved, 1);
+	close(saved);
+	remove("test_stdout.tmp");
+}
+
 // --- UNIT TESTS (Logic) ---
 
 TEST(test_scan_basic) {
@@ -71,6 +91,117 @@ TEST(test_scan_limited) {
 	cleanup_stdin();
 }
 
+TEST(test_lines_cursor) {
+	// Drain input left behind by earlier scans before swapping stdin.
+	String line;
+	while (io.lines(&line)) {
+	}
+
+	mock_stdin("alpha\r\nbeta\n\ngamma");
+
+	REQUIRE(io.lines(&line) && string.equal(line, string.from("alpha")));
+	REQUIRE(io.lines(&line) && string.equal(line, string.from("beta")));
+	REQUIRE(io.lines(&line) && line.len == 0);
+	REQUIRE(io.lines(&line) && string.equal(line, string.from("gamma")));
+	REQUIRE(!io.lines(&line));
+	cleanup_stdin();
+
+	// A CR without a following LF is line content, not a terminator.
+	mock_stdin("delta\r");
+	REQUIRE(io.lines(&line) && string.equal(line, string.from("delta\r")));
+	REQUIRE(!io.lines(&line));
+
+	cleanup_stdin();
+}
+
+TEST(test_print_buffered) {
+	int saved = capture_stdout();
+	Arena a = arena.create(1024);
+
+	io.policy(FLUSH_FULL);
+	io.print("Value: %i %S%%\n", -42, string.from("ok"));
+
+	// Nothing reaches the descriptor until the buffer is flushed.
+	String before = io.slurp(&a, "test_stdout.tmp");
+	REQUIRE(before.len == 0);
+
+	io.flush();
+	String after = io.slurp(&a, "test_stdout.tmp");
+	REQUIRE(string.equal(after, string.from("Value: -42 ok%\n")));
+
+	io.policy(FLUSH_LINE);
+	io.put(string.from("line\n"));
+	String line = io.slurp(&a, "test_stdout.tmp");
+	REQUIRE(line.len == after.len + 5);
+
+	arena.release(&a);
+	restore_stdout(saved);
+}
+
+static void *print_and_exit(void *arg) {
+	(void)arg;
+	io.policy(FLUSH_FULL);
+	io.print("worker %i\n", 7);
+	return NULL; // No explicit flush: thread exit must deliver it.
+}
+
+TEST(test_print_thread_exit) {
+	int saved = capture_stdout();
+	Arena a = arena.create(1024);
+
+	pthread_t t;
+	pthread_create(&t, NULL, print_and_exit, NULL);
+	pthread_join(t, NULL);
+
+	String got = io.slurp(&a, "test_stdout.tmp");
+	REQUIRE(string.equal(got, string.from("worker 7\n")));
+
+	arena.release(&a);
+	restore_stdout(saved);
+}
+
+static bool contains(String hay, const char *needle) {
+	u64 n = strlen(needle);
+	for (u64 i = 0; i + n <= hay.len; i++) {
+		if (memcmp(hay.ptr + i, needle, n) == 0)
+			return true;
+	}
+	return false;
+}
+
+TEST(test_report) {
+	int saved = capture_stdout();
+	Arena out = arena.create(4096);
+
+	Arena a = arena.create(256);
+	ARENA_ALLOC(&a, 3);
+	ARENA_ALLOC(&a, 100);
+	ARENA_ALLOC(&a, 1024); // Fails: recorded as the first OOM
+	io.report(&a);
+	io.flush();
+
+	String got = io.slurp(&out, "test_stdout.tmp");
+	REQUIRE(got.len > 0 && memchr(got.ptr, '\0', got.len) == NULL);
+
+#ifdef CAMELOT_ARENA_STATS
+	const char *head = "[arena] used 108 / 256 bytes\n"
+					   "[arena] peak 108 | allocs 2 | requested 103 | padding 5 | failures 1\n"
+					   "[arena] sizes (<= bytes: allocs)\n"
+					   "    3: 1\n"
+					   "    127: 1\n"
+					   "[arena] sites (count / bytes)\n";
+	REQUIRE(got.len > strlen(head) && memcmp(got.ptr, head, strlen(head)) == 0);
+	REQUIRE(contains(got, "[arena] first OOM at "));
+	REQUIRE(contains(got, " requesting 1024 bytes\n"));
+#else
+	REQUIRE(string.equal(got, string.from("[arena] used 108 / 256 bytes\n")));
+#endif
+
+	arena.release(&a);
+	arena.release(&out);
+	restore_stdout(saved);
+}
+
 // --- VISUAL CHECK ---
 
 TEST(test_io_visual) {
@@ -132,5 +263,9 @@ TEST(test_io_visual) {
 void test_io() {
 	RUN(test_scan_basic);
 	RUN(test_scan_limited);
+	RUN(test_lines_cursor);
+	RUN(test_print_buffered);
+	RUN(test_print_thread_exit);
+	RUN(test_report);
 	// RUN(test_io_visual); // Optional: Uncomment to see output
 }
\ No newline at end of file
@@ -8,7 +8,10 @@
  */
 
 // clang-format off
+#include <pthread.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include "camelot.h"
 #include "tests.h"
 // clang-format on
@@ -28,6 +31,52 @@ TEST(test_alignment) {
 	arena.release(&a);
 }
 
+TEST(test_aligned_alloc) {
+	Arena a = arena.create(4096);
+
+	arena.alloc(&a, 3);
+	void *v = arena.alloc_aligned(&a, 32, 32);
+	void *line = arena.alloc_aligned(&a, 8, CACHE_LINE);
+	void *odd = arena.alloc_aligned(&a, 8, 24); // Rounded up to 32
+
+	REQUIRE(((uintptr_t)v % 32) == 0);
+	REQUIRE(((uintptr_t)line % CACHE_LINE) == 0);
+	REQUIRE(((uintptr_t)odd % 32) == 0);
+	arena.release(&a);
+
+	// Arena-wide default alignment applies to plain arena.alloc.
+	Arena wide = arena.reserve((ArenaOptions){.reserve = 1 << 16, .align = CACHE_LINE});
+	arena.alloc(&wide, 1);
+	void *p = arena.alloc(&wide, 1);
+	REQUIRE(((uintptr_t)p % CACHE_LINE) == 0);
+	arena.release(&wide);
+}
+
+TEST(test_extend) {
+	Arena a = arena.create(1024);
+
+	u64 *first = arena.alloc(&a, 4 * sizeof(u64));
+	REQUIRE(first != NULL);
+	if (first) {
+		first[3] = 7;
+	}
+
+	// Most recent allocation: grows without moving.
+	u64 *grown = arena.extend(&a, first, 4 * sizeof(u64), 8 * sizeof(u64));
+	REQUIRE(grown == first);
+	REQUIRE(a.len == 8 * sizeof(u64));
+
+	// Not the tail anymore: falls back to a copy.
+	arena.alloc(&a, 8);
+	u64 *moved = arena.extend(&a, grown, 8 * sizeof(u64), 16 * sizeof(u64));
+	REQUIRE(moved != NULL && moved != grown);
+	if (moved) {
+		REQUIRE(moved[3] == 7);
+	}
+
+	arena.release(&a);
+}
+
 TEST(test_oom) {
 	Arena a = arena.create(16);
 
@@ -42,6 +91,393 @@ TEST(test_oom) {
 	arena.release(&a);
 }
 
+TEST(test_growable_arena) {
+	Arena a = arena.reserve((ArenaOptions){.reserve = 1 << 24, .commit = 4096, .floor = 8192});
+	REQUIRE(a.status == OK);
+	REQUIRE(a.cap == 4096);
+
+	u64 *first = arena.alloc(&a, sizeof(u64));
+	REQUIRE(first != NULL);
+	if (first) {
+		*first = 0xC0FFEE;
+	}
+
+	// Grow well past the initial commit; earlier pointers must stay valid.
+	for (int i = 0; i < 64; i++) {
+		REQUIRE(arena.alloc(&a, 4096) != NULL);
+	}
+	REQUIRE(a.status == OK);
+	REQUIRE(a.cap > 64 * 4096);
+	if (first) {
+		REQUIRE(*first == 0xC0FFEE);
+	}
+
+	// Clearing decommits back to the floor; regrowth yields zeroed pages.
+	arena.clear(&a);
+	REQUIRE(a.cap == 8192);
+	u8 *fresh = arena.alloc(&a, 1 << 16);
+	REQUIRE(fresh != NULL);
+	if (fresh) {
+		REQUIRE(fresh[(1 << 16) - 1] == 0);
+	}
+
+	// The reserved range is still a hard ceiling.
+	REQUIRE(arena.alloc(&a, 1 << 25) == NULL);
+	REQUIRE(a.status == OOM);
+
+	arena.release(&a);
+}
+
+TEST(test_zero_policies) {
+	u64 size = 256 * 1024;
+	ArenaOptions opts = {.reserve = size, .commit = size, .floor = size};
+
+	// Lazy: large regions are handed back to the OS but still read as zero.
+	opts.zero = ZERO_LAZY;
+	Arena lazy = arena.reserve(opts);
+	u8 *p = arena.alloc(&lazy, size - 100);
+	REQUIRE(p != NULL);
+	if (p) {
+		p[0] = 0xAA;
+		p[size - 101] = 0xBB;
+		arena.clear(&lazy);
+		REQUIRE(p[0] == 0);
+		REQUIRE(p[size - 101] == 0);
+	}
+	arena.release(&lazy);
+
+	// None: the cursor resets but contents are left untouched.
+	opts.zero = ZERO_NONE;
+	Arena raw = arena.reserve(opts);
+	u8 *q = arena.alloc(&raw, 64);
+	REQUIRE(q != NULL);
+	if (q) {
+		q[0] = 0xCC;
+		arena.clear(&raw);
+		REQUIRE(raw.len == 0);
+		REQUIRE(q[0] == 0xCC);
+	}
+	arena.release(&raw);
+}
+
+TEST(test_huge_pages) {
+	u64 mib = 1 << 20;
+	Arena a = arena.reserve((ArenaOptions){
+		.reserve = 8 * mib,
+		.commit = 4 * mib,
+		.pages = PAGES_HUGE | PAGES_PREFAULT,
+	});
+	REQUIRE(a.status == OK);
+
+	// Whatever the host grants, the request degrades gracefully.
+	REQUIRE(a.pages & PAGES_PREFAULT);
+	if (a.pages & PAGES_HUGETLB) {
+		REQUIRE(a.cap == a.reserved);
+	}
+	if (a.pages & PAGES_THP) {
+		REQUIRE(((uintptr_t)a.buf % (2 * mib)) == 0);
+	}
+
+	u8 *p = arena.alloc(&a, 6 * mib); // Grows past the prefaulted commit
+	REQUIRE(p != NULL);
+	if (p) {
+		p[6 * mib - 1] = 1;
+	}
+	arena.release(&a);
+}
+
+TEST(test_savepoints) {
+	Arena a = arena.create(1024);
+
+	void *keep = arena.alloc(&a, 16);
+	REQUIRE(keep != NULL);
+	u64 before = a.len;
+
+	{
+		Savepoint sp = arena.mark(&a);
+		u8 *tmp = arena.alloc(&a, 512);
+		REQUIRE(tmp != NULL);
+		if (tmp) {
+			tmp[0] = 0xEE;
+		}
+		REQUIRE(a.len > before);
+		// 'sp' rewinds the arena here
+	}
+
+	REQUIRE(a.len == before);
+	u8 *again = arena.alloc(&a, 512);
+	REQUIRE(again != NULL);
+	if (again) {
+		REQUIRE(again[0] == 0); // Rewound bytes are scrubbed
+	}
+
+	// Scratch arenas never alias the caller's arena.
+	ArenaMark s1 = arena.scratch(NULL);
+	ArenaMark s2 = arena.scratch(s1.arena);
+	REQUIRE(s1.arena != NULL && s2.arena != NULL);
+	REQUIRE(s1.arena != s2.arena);
+	REQUIRE(arena.alloc(s2.arena, 1 << 20) != NULL);
+	arena.rewind(s2);
+	REQUIRE(s2.arena->len == s2.len);
+
+	arena.release(&a);
+}
+
+TEST(test_object_pool) {
+	Workspace a = arena.create(4096);
+	Pool p = pool.create(&a, sizeof(u64) * 3, 4);
+
+	u64 *slots[10];
+	for (int i = 0; i < 10; i++) {
+		slots[i] = pool.alloc(&p);
+		REQUIRE(slots[i] != NULL);
+	}
+	REQUIRE(p.live == 10);
+
+	// Recycled slots are handed back out before the arena grows.
+	u64 used = a.len;
+	if (slots[3]) {
+		slots[3][1] = 77;
+	}
+	pool.recycle(&p, slots[3]);
+	u64 *again = pool.alloc(&p);
+	REQUIRE(again == slots[3]);
+	if (again) {
+		REQUIRE(again[0] == 0 && again[1] == 0);
+	}
+	REQUIRE(a.len == used);
+	REQUIRE(p.live == 10);
+}
+
+#define SHARED_WORKERS 4
+#define SHARED_ITEMS 5000
+
+typedef struct {
+	SharedArena *region;
+	int id;
+	bool ok;
+} SharedJob;
+
+static void *shared_worker(void *arg) {
+	SharedJob *job = arg;
+	Arena local = shared.attach(job->region);
+
+	// Existing containers run unchanged on a view.
+	List items = list.create(&local, sizeof(int));
+	for (int i = 0; i < SHARED_ITEMS; i++) {
+		int v = job->id * SHARED_ITEMS + i;
+		list.push(&items, &v);
+	}
+
+	job->ok = local.status == OK && items.count == SHARED_ITEMS;
+	for (u64 i = 0; i < items.count; i++) {
+		int *v = list.get(&items, i);
+		if (!v || *v != job->id * SHARED_ITEMS + (int)i)
+			job->ok = false;
+	}
+
+	arena.release(&local);
+	return NULL;
+}
+
+TEST(test_shared_arena) {
+	SharedArena region = shared.create(1 << 24, 4096);
+	REQUIRE(region.status == OK);
+
+	pthread_t threads[SHARED_WORKERS];
+	SharedJob jobs[SHARED_WORKERS];
+	for (int i = 0; i < SHARED_WORKERS; i++) {
+		jobs[i] = (SharedJob){.region = &region, .id = i};
+		pthread_create(&threads[i], NULL, shared_worker, &jobs[i]);
+	}
+	for (int i = 0; i < SHARED_WORKERS; i++) {
+		pthread_join(threads[i], NULL);
+		REQUIRE(jobs[i].ok);
+	}
+
+	u64 used = shared.usage(&region);
+	REQUIRE(used >= SHARED_WORKERS * SHARED_ITEMS * sizeof(int));
+	REQUIRE(used <= region.carved);
+
+	REQUIRE(shared.alloc(&region, 64) != NULL);
+	REQUIRE(shared.alloc(&region, 1 << 25) == NULL);
+	REQUIRE(region.status == OOM);
+
+	shared.release(&region);
+}
+
+TEST(test_arena_stats) {
+	Arena a = arena.create(256);
+
+	void *p1 = ARENA_ALLOC(&a, 3);
+	void *p2 = ARENA_ALLOC(&a, 100);
+	REQUIRE(p1 != NULL && p2 != NULL);
+	REQUIRE(ARENA_ALLOC(&a, 1024) == NULL);
+
+#ifdef CAMELOT_ARENA_STATS
+	REQUIRE(a.stats != NULL);
+	if (a.stats) {
+		REQUIRE(a.stats->count == 2);
+		REQUIRE(a.stats->bytes == 103);
+		REQUIRE(a.stats->padding == 5);
+		REQUIRE(a.stats->peak == a.len);
+		REQUIRE(a.stats->histogram[2] == 1); // 3 bytes
+		REQUIRE(a.stats->histogram[7] == 1); // 100 bytes
+		REQUIRE(a.stats->sites[0].count == 1 && a.stats->sites[1].count == 1);
+		REQUIRE(a.stats->failures == 1);
+		REQUIRE(a.stats->oom.line != 0 && a.stats->oom.bytes == 1024);
+	}
+#endif
+
+	arena.release(&a);
+}
+
+TEST(test_arena_image) {
+	const char *path = "test_arena.img";
+	remove(path);
+
+	// 1. Build a table whose keys, values and struct all live in the image.
+	Arena db = arena.map(path, 1 << 16);
+	REQUIRE(db.status == OK);
+	REQUIRE(arena.root(&db) == NULL);
+
+	Table *t = arena.alloc(&db, sizeof(Table));
+	int *v = arena.alloc(&db, sizeof(int));
+	if (t && v) {
+		*v = 1234;
+		*t = table.create(&db, 16);
+		table.put(t, string.join(&db, string.from("answer"), string.from("")), v);
+	}
+	REQUIRE(arena.snapshot(&db, t) == OK);
+	arena.release(&db);
+
+	// 2. Reload: same address, so interior pointers are valid.
+	Arena again = arena.map(path, 0);
+	REQUIRE(again.status == OK);
+
+	// While 'again' holds the address, a second map must fail and keep the file.
+	Arena busy = arena.map(path, 1 << 16);
+	REQUIRE(busy.status == IO_ERROR);
+	REQUIRE(arena.root(&again) == t);
+
+	Table *loaded = arena.root(&again);
+	REQUIRE(loaded == t);
+	if (loaded) {
+		loaded->source = &again;
+		int *got = table.get(loaded, string.from("answer"));
+		REQUIRE(got != NULL && *got == 1234);
+	}
+
+	// 3. Modified after the snapshot: the stale image is rejected.
+	arena.alloc(&again, 8);
+	u64 *dirty = (u64 *)again.buf;
+	*dirty ^= 1;
+	arena.release(&again);
+
+	Arena stale = arena.map(path, 1 << 16);
+	REQUIRE(stale.status == OK);
+	REQUIRE(arena.root(&stale) == NULL);
+	REQUIRE(stale.len == 0);
+	arena.release(&stale);
+
+	remove(path);
+}
+
+TEST(test_heap) {
+	Workspace a = arena.reserve((ArenaOptions){.reserve = 1 << 26});
+	Heap h = heap.create(&a, 0);
+
+	// Random churn: every live block keeps its own byte pattern.
+	u8 *live[64] = {0};
+	u64 sizes[64] = {0};
+	u64 seed = 42;
+	bool intact = true;
+
+	for (int step = 0; step < 20000; step++) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		u64 slot = (seed >> 33) % 64;
+		if (live[slot]) {
+			for (u64 i = 0; i < sizes[slot]; i++) {
+				if (live[slot][i] != (u8)slot)
+					intact = false;
+			}
+			if (step & 1) {
+				heap.recycle(&h, live[slot]);
+				live[slot] = NULL;
+				continue;
+			}
+			sizes[slot] = 1 + (seed >> 40) % 3000;
+			live[slot] = heap.resize(&h, live[slot], sizes[slot]);
+		} else {
+			sizes[slot] = 1 + (seed >> 40) % 3000;
+			live[slot] = heap.alloc(&h, sizes[slot]);
+		}
+		if (live[slot]) {
+			memset(live[slot], (int)slot, sizes[slot]);
+		}
+	}
+	REQUIRE(intact);
+
+	for (int i = 0; i < 64; i++) {
+		heap.recycle(&h, live[i]);
+	}
+	REQUIRE(h.used == 0);
+
+	// Fully coalesced: a large block fits without growing the arena.
+	u64 before = a.len;
+	void *big = heap.alloc(&h, 128 * 1024);
+	REQUIRE(big != NULL);
+	REQUIRE(a.len == before);
+	heap.recycle(&h, big);
+
+	// Containers run on a heap view; grown arrays are recycled.
+	Arena view = heap.arena(&h);
+	Table t = table.create(&view, 16);
+	int vals[200];
+	for (int i = 0; i < 200; i++) {
+		vals[i] = i;
+		table.put(&t, (String){.ptr = (u8 *)&vals[i], .len = sizeof(int)}, &vals[i]);
+	}
+	int *got = table.get(&t, (String){.ptr = (u8 *)&vals[150], .len = sizeof(int)});
+	REQUIRE(got != NULL && *got == 150);
+	REQUIRE(((uintptr_t)t.entries % CACHE_LINE) == 0);
+	REQUIRE(h.used < (sizeof(Entry) + 1) * t.cap + TABLE_GROUP + 256);
+	REQUIRE(view.status == OK);
+}
+
+TEST(test_heap_zero_size) {
+	Workspace a = arena.reserve((ArenaOptions){.reserve = 1 << 22});
+	Heap h = heap.create(&a, 0);
+	Arena view = heap.arena(&h);
+
+	// Size 0 behaves like a bump arena: a valid, recyclable pointer.
+	void *p = arena.alloc(&view, 0);
+	REQUIRE(p != NULL);
+	REQUIRE(view.status == OK);
+
+	// Over-aligned size 0 must not split the block into a negative size.
+	void *q = arena.alloc_aligned(&view, 0, 64);
+	REQUIRE(q != NULL);
+	REQUIRE(((uintptr_t)q % 64) == 0);
+	REQUIRE(view.status == OK);
+
+	u64 *r = arena.alloc_aligned(&view, 3 * sizeof(u64), 64);
+	REQUIRE(r != NULL);
+	r[0] = r[1] = r[2] = 7;
+
+	// Extending to 0 shrinks in place instead of recycling and reporting OOM.
+	u64 before = h.used;
+	u64 *s = arena.extend(&view, r, 3 * sizeof(u64), 0);
+	REQUIRE(s == r);
+	REQUIRE(view.status == OK);
+	REQUIRE(h.used <= before);
+
+	heap.recycle(&h, p);
+	heap.recycle(&h, q);
+	heap.recycle(&h, s);
+	REQUIRE(h.used == 0);
+}
+
 TEST(test_workspace_macro) {
 	// Verifies that the 'Workspace' syntax compiles and runs.
 	// If the cleanup logic was broken, this might segfault on scope exit.
@@ -59,6 +495,18 @@ TEST(test_workspace_macro) {
 
 void test_memory() {
 	RUN(test_alignment);
+	RUN(test_aligned_alloc);
+	RUN(test_extend);
 	RUN(test_oom);
+	RUN(test_growable_arena);
+	RUN(test_zero_policies);
+	RUN(test_huge_pages);
+	RUN(test_savepoints);
+	RUN(test_object_pool);
+	RUN(test_shared_arena);
+	RUN(test_arena_stats);
+	RUN(test_arena_image);
+	RUN(test_heap);
+	RUN(test_heap_zero_size);
 	RUN(test_workspace_macro);
 }
\ No newline at end of file
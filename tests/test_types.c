@@ -33,6 +33,25 @@ TEST(test_string_construction) {
 	arena.release(&a);
 }
 
+TEST(test_string_append) {
+	Arena a = arena.create(1024);
+
+	String out = string.join(&a, string.from("ab"), string.from(""));
+	u8 *start = out.ptr;
+	for (int i = 0; i < 10; i++) {
+		out = string.append(&a, out, string.from("xyz"));
+	}
+
+	REQUIRE(out.ptr == start); // Grew in place
+	REQUIRE(out.len == 32);
+	REQUIRE(a.len == out.len + 1);
+	REQUIRE(out.ptr[out.len] == '\0');
+	REQUIRE(memcmp(out.ptr + 29, "xyz", 3) == 0);
+
+	arena.release(&a);
+}
+
 void test_types() {
 	RUN(test_string_construction);
+	RUN(test_string_append);
 }
\ No newline at end of file